@@ -0,0 +1,65 @@
+#pragma once
+
+#include <elhaylib.h>
+#include <rng.h>
+#include <sel.h>
+#include <sol.h>
+
+// Checkpoints of the classic first solution search and of the single
+// threaded enumeration
+// A checkpoint holds everything needed to continue a run exactly where it
+// stopped: the search path with the tiles left to try at every placement,
+// the free piece counts, the PRNG state and the counters. The board is
+// rebuilt on resume by placing the path again. The transposition table is
+// a cache and not part of a checkpoint.
+// The file is written in the byte order of the machine, a magic and a
+// version number guard against reading a foreign file.
+#define CKPT_MAGIC "PPCKPT"
+#define CKPT_VERSION 3
+#define CKPT_MAX_TILE_TYPES 16
+
+typedef enum { CKPT_MODE_TREE, CKPT_MODE_ENUMERATE, N_CKPT_MODES } CKPT_MODE;
+
+typedef struct {
+    // CKPT_MODE
+    int mode;
+    int puzzle_type;
+    int prune_rules;
+    bool break_symmetry;
+    // SELECT_STRATEGY
+    int select_strategy;
+    uint64_t seed;
+    rng_state rng;
+
+    uint64_t n_iterations;
+    uint64_t n_pruned_nodes;
+    uint64_t tt_hits;
+    uint64_t tt_misses;
+    uint64_t prune_hits[N_PRUNE_RULES];
+    // cpu time of all runs before this checkpoint
+    double cpu_time;
+
+    // the counters of a search_state, n_iterations holds its nodes
+    uint64_t n_backtracks;
+    int deepest_depth;
+    uint64_t n_solutions;
+    uint64_t n_unique_solutions;
+    uint64_t n_raw_solutions;
+
+    uint8_t free_pieces[CKPT_MAX_TILE_TYPES];
+    int path_depth;
+    // path_depth + 1 placements, in the tree mode path[0] is the root tile,
+    // in the enumeration mode path[path_depth] may not be placed yet
+    node_placement* path;
+    // enumeration only, the level_solutions of the search_state
+    uint64_t* level_solutions;
+} checkpoint;
+
+// The file is written next to path, synced to disk and renamed over it,
+// so an interrupted write or a crash never destroys the previous
+// checkpoint. Returns false on failure
+bool ckpt_write(char const* path, checkpoint const* ckpt);
+// ckpt->path and ckpt->level_solutions are allocated, returns false if the
+// file is missing or invalid
+bool ckpt_read(char const* path, checkpoint* ckpt);
+void ckpt_free(checkpoint* ckpt);
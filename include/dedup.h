@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdio.h>
+
+#include <elhaylib.h>
+#include <puz.h>
+#include <sol.h>
+
+// Deduplication of solutions under the symmetries of the board
+// A solution is identified by the fingerprint of its canonical form, see
+// get_canonical_fingerprint, so all of its rotated and mirrored copies
+// collapse into one entry. The set keeps the fingerprints in a fixed size
+// open addressing table. Without a file the table doubles once it is
+// three quarters full. With a file the table is sorted and merged into the
+// file instead, which holds every fingerprint seen so far in ascending
+// order and is searched in place. The memory use is then bounded by the
+// table, and the file can be reused to merge further solution sets.
+// Two different tilings share a fingerprint with a chance of about
+// n^2 / 2^65 for n solutions.
+#define DEDUP_MAGIC "PPDDUP"
+#define DEDUP_VERSION 1
+#define DEDUP_HEADER_SIZE 16
+#define DEDUP_DEFAULT_SIZE_MB 64
+
+typedef struct {
+    // 0 marks an empty slot, a fingerprint of 0 is stored as 1
+    uint64_t* slots;
+    size_t n_slots;
+    size_t n_used;
+
+    // optional, the sorted fingerprints of the file, mapped read-only
+    char const* path;
+    uint8_t const* data;
+    size_t size;
+    uint64_t const* sorted;
+    size_t n_sorted;
+
+    uint64_t n_inserted;
+    uint64_t n_duplicates;
+    size_t n_flushes;
+} dedup_set;
+
+// path may be NULL for a set that only lives in memory, an existing file
+// is loaded. size_mb is rounded down to a power of two number of slots.
+// Returns false if the file is not a fingerprint set
+bool dedup_open(dedup_set* set, char const* path, size_t size_mb);
+// Returns true if the fingerprint was not in the set yet
+bool dedup_insert(dedup_set* set, uint64_t fingerprint);
+// Total number of fingerprints in memory and on disk
+size_t dedup_size(dedup_set* set);
+// Writes the table to the file, returns false if that fails
+bool dedup_close(dedup_set* set);
+
+// The placements of the canonical form in the order of the first empty
+// cell search, i.e. by the row-major position of their top left cell.
+// puzzle has to be solved, placements receives one entry per piece
+void dedup_canonical_placements(puzzle_def* puzzle,
+                                int transform,
+                                node_placement* placements);
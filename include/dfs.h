@@ -0,0 +1,95 @@
+#pragma once
+
+#include <elhaylib.h>
+#include <puz.h>
+#include <rng.h>
+#include <sel.h>
+#include <sol.h>
+#include <stdatomic.h>
+#include <tt.h>
+
+#define DFS_PROGRESS_INTERVAL 100000
+
+// Depth-bounded search
+// Instead of recording every node ever tried in a tree, only the current
+// path of placements is kept in a fixed array. The array is sized to the
+// number of pieces of the puzzle, which is the deepest a path can get.
+// path[d].valid_tiles holds the tiles that are still untried at depth d.
+typedef enum { SEARCH_FIRST, SEARCH_COUNT } SEARCH_MODE;
+
+typedef struct search_state search_state;
+typedef void (*SOLUTION_F_PTR)(search_state*, void*);
+
+struct search_state {
+    puzzle_def* puzzle;
+    SEARCH_MODE mode;
+
+    node_placement* path;
+    int depth;
+    int max_depth;
+
+    uint64_t n_nodes;
+    // placements taken back and the deepest level opened so far
+    uint64_t n_backtracks;
+    int deepest_depth;
+    // tilings reached by the search
+    uint64_t n_solutions;
+    // reached tilings that are the smallest of their symmetric copies and
+    // the number of copies they stand for
+    uint64_t n_unique_solutions;
+    uint64_t n_raw_solutions;
+
+    // only explore tilings with ordered corners, see is_symmetry_allowed
+    bool break_symmetry;
+
+    // bit mask of PRUNE_MASK(rule), hits are counted per rule
+    int prune_rules;
+    uint64_t n_prunes[N_PRUNE_RULES];
+
+    // optional, dead boards are stored on backtracking and cut off when
+    // they are reached again, may be shared between states
+    tt_table* tt;
+    uint64_t n_tt_hits;
+    uint64_t n_tt_misses;
+    // n_solutions when the level at depth d was opened, a level that is
+    // left with the same count was dead
+    uint64_t* level_solutions;
+
+    // optional, called for every complete tiling
+    SOLUTION_F_PTR solution_func;
+    void* solution_ctx;
+    // optional, called every DFS_PROGRESS_INTERVAL nodes
+    SOLUTION_F_PTR progress_func;
+    void* progress_ctx;
+
+    // optional, picks the next tile to try, see sel.h, tiles are tried in
+    // ascending order without it
+    SELECT_F_PTR select_func;
+    void* select_ctx;
+    // optional, the search stops once n_nodes reaches the limit, the path
+    // and the board are left as they were at that point
+    uint64_t node_limit;
+
+    // optional, the search stops as soon as it is set
+    // the path and the board are left as they were at that point
+    atomic_bool* cancel;
+};
+
+// puzzle is expected to be initialized with init_puzzle()
+void dfs_init(search_state* state, puzzle_def* puzzle, SEARCH_MODE mode);
+bool dfs_run(search_state* state);
+// Continues a search that was stopped by cancel or node_limit, with the
+// path and the board as they were left, until it is back at base_depth.
+// path[0..depth] can also be restored from a checkpoint.
+bool dfs_resume(search_state* state, int base_depth);
+void dfs_free(search_state* state);
+// Removes the placements of an interrupted run from the board and resets
+// the path to depth
+void dfs_unwind(search_state* state, int depth);
+
+// Counts the solved board and calls the solution callback, the path has
+// to end with the last placement at path[depth]
+void dfs_record_solution(search_state* state);
+
+int dfs_max_depth(int puzzle_type);
+uint16_t dfs_available_tiles(puzzle_def* puzzle);
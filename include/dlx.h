@@ -0,0 +1,21 @@
+#pragma once
+
+#include <dfs.h>
+#include <elhaylib.h>
+#include <puz.h>
+
+// Exact cover search with dancing links (Knuth's Algorithm X)
+// Every placement of a piece on free cells is a row of a sparse 0/1
+// matrix. A row has a node in the column of every cell it covers and one
+// in the column of its piece size. The cell columns have to be covered
+// exactly once, a piece column can be hit as often as there are pieces of
+// that size left. The search always branches on the cell column with the
+// fewest rows left.
+//
+// The engine runs on a search_state, so the callbacks, the counters and
+// the path are the same as for dfs_run(). Placements are mirrored onto
+// the board, it holds the solution for SEARCH_FIRST and is left as it was
+// for SEARCH_COUNT. The prune rules are checked after every placement and
+// node_limit is honored. The symmetry filter is not supported, as the
+// corners are not filled in a fixed order.
+bool dlx_run(search_state* state);
@@ -137,18 +137,49 @@ bool stack_peek(stack_head* stack, void* out);
 void stack_push(stack_head* stack, void const* in);
 void stack_free(stack_head* stack);
 
+// ARENA
+// Bump allocator over a list of large chunks. Allocations are zeroed and
+// cannot be freed one by one, the arena is reset or freed as a whole.
+#define ARENA_DEFAULT_CHUNK_SIZE ((size_t)1 << 20)
+
+typedef struct arena_chunk arena_chunk;
+typedef struct {
+    size_t chunk_size;
+    size_t chunk_used;
+    size_t n_chunks;
+    size_t bytes_allocated;
+    arena_chunk* ptr_chunk;
+} arena_head;
+
+// chunk_size 0 selects ARENA_DEFAULT_CHUNK_SIZE
+void arena_init(arena_head* const ptr_head, size_t chunk_size);
+void* arena_alloc(arena_head* const ptr_head, size_t size);
+// Releases every allocation, the last chunk is kept for reuse
+void arena_reset(arena_head* const ptr_head);
+void arena_free(arena_head* const ptr_head);
+
 // TREE
+// Trees initialized with tree_init_arena take their nodes from the arena,
+// so a node add costs no heap allocation. The memory is only released
+// with the arena, which has to outlive the tree. Subtrees of an arena tree
+// may only be grafted into trees with an arena.
 typedef struct tree_node tree_node;
 typedef struct {
     size_t tree_size;
     tree_node* tree_root;
+    arena_head* arena;
+    // pruned arena nodes, linked through their parent pointer
+    tree_node* free_nodes;
 } tree_head;
 
+// The children of a node are a singly linked list, starting at first_child
+// and chained through next_sibling, so a leaf costs no child storage
 struct tree_node {
     tree_node* parent;
-    dynarr_head children;
+    tree_node* first_child;
+    tree_node* next_sibling;
     node_type dtype;
-    size_t data_size;
+    uint32_t data_size;
     char data[];
 };
 
@@ -158,6 +189,7 @@ typedef struct {
 } tree_op_res;
 
 void tree_init(tree_head* const ptr_head);
+void tree_init_arena(tree_head* const ptr_head, arena_head* const arena);
 void tree_node_root(tree_op_res* op_res,
                     tree_head* const ptr_head,
                     node_type dtype,
@@ -200,12 +232,14 @@ void tree_detach_graft_subtree(tree_op_res* op_res,
                                tree_node* ptr_node,
                                size_t graft_index);
 
+// Both walk the subtree iteratively and work on trees of any depth
 void tree_prune(tree_op_res* op_res,
                 tree_head* const ptr_head,
                 tree_node* ptr_node);
 void tree_free(tree_op_res* op_res, tree_head* const ptr_head);
 
 tree_node* tree_get_ith_node_ptr(tree_node* ptr_node, size_t i);
+size_t tree_n_children(tree_node* ptr_node);
 size_t tree_count_nodes(tree_node* ptr_node);
 
 // TREE Traversals
@@ -241,6 +275,18 @@ void tree_traversal_in_order(float in_order_partition,
 tree_node* tree_prepare_node(node_type dtype,
                              size_t data_size,
                              void const* data);
+tree_node* tree_prepare_arena_node(arena_head* const arena,
+                                   node_type dtype,
+                                   size_t data_size,
+                                   void const* data);
+tree_node* tree_new_node(tree_head* const ptr_head,
+                         node_type dtype,
+                         size_t data_size,
+                         void const* data);
+void tree_link_child(tree_node* const ptr_parent,
+                     tree_node* const ptr_node,
+                     size_t index);
+void tree_unlink_child(tree_node* const ptr_node);
 void tree_free_node(tree_op_res* op_res,
                     tree_head* const ptr_head,
                     tree_node* const ptr_node);
\ No newline at end of file
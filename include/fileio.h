@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Writes a file as path.tmp and renames it over path once it is complete
+// and synced to disk, so a crash never leaves a partial file behind.
+typedef struct {
+    char const* path;
+    char* tmp_path;
+    FILE* file_ptr;
+} file_replace;
+
+// Opens path.tmp with the fopen mode, returns false with errno set if the
+// file cannot be created
+bool file_replace_open(file_replace* const file,
+                       char const* path,
+                       char const* mode);
+// Syncs, closes and renames the file if is_ok, otherwise and on failure
+// the temporary file is removed and path is kept. Returns false on failure
+// with errno set
+bool file_replace_commit(file_replace* const file, bool is_ok);
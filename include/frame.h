@@ -0,0 +1,61 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <elhaylib.h>
+#include <sol.h>
+
+#define FRAME_DEFAULT_FPS 30
+
+// Visualizer frames
+// The search publishes its placement path into a double buffer and a
+// render thread draws it at a fixed frame rate. The render thread takes
+// the front buffer and raises is_requested, the search only checks that
+// flag per node and copies its path into the back buffer once it is set.
+// The new front is published before the flag is cleared, so the search
+// never writes the buffer that is being drawn and neither side locks.
+typedef void (*FRAME_DRAW_F_PTR)(node_placement const* placements,
+                                 int n_placements,
+                                 void* ctx);
+
+typedef struct {
+    node_placement* placements;
+    int n_placements;
+} frame_buffer;
+
+typedef struct {
+    frame_buffer buffers[2];
+    int max_placements;
+    atomic_int front;
+    atomic_bool is_requested;
+    atomic_bool is_stopped;
+
+    // frames per second
+    int fps;
+    FRAME_DRAW_F_PTR draw_func;
+    void* draw_ctx;
+    pthread_t thread;
+    bool is_running;
+    uint64_t n_frames;
+} frame_state;
+
+void frame_init(frame_state* frames,
+                int max_placements,
+                int fps,
+                FRAME_DRAW_F_PTR draw_func,
+                void* draw_ctx);
+// Starts the render thread, returns false if it cannot be created
+bool frame_start(frame_state* frames);
+// Joins the render thread, the last frame may not have been drawn
+void frame_stop(frame_state* frames);
+void frame_free(frame_state* frames);
+
+// Called by the search for every node, cheap unless a frame is due
+static inline bool frame_is_due(frame_state* frames) {
+    return atomic_load_explicit(&frames->is_requested, memory_order_relaxed);
+}
+// placements holds n_placements <= max_placements entries
+void frame_publish(frame_state* frames,
+                   node_placement const* placements,
+                   int n_placements);
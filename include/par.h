@@ -0,0 +1,59 @@
+#pragma once
+
+#include <dfs.h>
+#include <elhaylib.h>
+#include <puz.h>
+
+#define PAR_MAX_PREFIX 8
+#define PAR_TASKS_PER_THREAD 32
+
+// Parallel search
+// The search space is split into tasks by short placement prefixes, i.e.
+// the root tile and the first few placements after it. The tasks are dealt
+// round-robin into one deque per worker. A worker pops from the bottom of
+// its own deque and steals from the top of the others once it runs dry.
+// Every worker owns its board and its search_state.
+typedef struct {
+    int n_placements;
+    node_placement placements[PAR_MAX_PREFIX];
+} par_task;
+
+typedef struct {
+    int n_threads;
+    // 0 := grow the prefixes until there are enough tasks per thread
+    int prefix_depth;
+    SEARCH_MODE mode;
+    int prune_rules;
+    bool break_symmetry;
+    // optional, shared by all workers
+    tt_table* tt;
+    // optional, see search_state, the ctx is shared by all workers
+    SELECT_F_PTR select_func;
+    void* select_ctx;
+
+    // optional, calls are serialized across the workers
+    SOLUTION_F_PTR solution_func;
+    void* solution_ctx;
+
+    // results
+    size_t n_tasks;
+    uint64_t n_nodes;
+    uint64_t n_solutions;
+    uint64_t n_unique_solutions;
+    uint64_t n_raw_solutions;
+    uint64_t n_prunes[N_PRUNE_RULES];
+    uint64_t n_tt_hits;
+    uint64_t n_tt_misses;
+} par_settings;
+
+// puzzle is expected to be initialized with init_puzzle(), the search
+// starts from its current board
+// SEARCH_FIRST: the first found solution is placed on puzzle and the
+// other workers are cancelled
+// SEARCH_COUNT: all tasks are exhausted and the counts are summed up
+bool par_search(puzzle_def* puzzle, par_settings* settings);
+
+void par_make_tasks(puzzle_def* puzzle,
+                    dynarr_head* tasks,
+                    par_settings* settings,
+                    size_t min_tasks);
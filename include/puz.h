@@ -2,17 +2,88 @@
 
 #include <elhaylib.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 typedef struct block_def {
     int size;
     int free_pieces;
 } block_def;
 
+#define ROW_WORD_BITS 64
+#define PUZZLE_GRID_DIMENSION(size) ((size) * ((size) + 1) / 2)
+#define PUZZLE_ROW_WORDS(size)                                                \
+    ((PUZZLE_GRID_DIMENSION(size) + ROW_WORD_BITS - 1) / ROW_WORD_BITS)
+
+// Sums of remaining tile sizes, one bit per sum up to the grid dimension
+// (136 for the largest puzzle type of 16)
+#define SUBSET_SUM_WORDS 3
+#define SUBSET_SUM_CACHE_SIZE 4096
+
+// Memo of the reachable sums keyed on the remaining piece counts, each
+// count takes one byte of the key: sizes 1-8 in key[0], 9-16 in key[1]
+typedef struct {
+    bool is_set;
+    uint64_t key[2];
+    uint64_t sums[SUBSET_SUM_WORDS];
+} subset_sum_entry;
+
+// Run of neighbouring columns with the same filled height
+typedef struct {
+    int x_pos;
+    int width;
+    int height;
+} skyline_segment;
+
+// puzzle_grid holds the tile size at the top left cell of every placed
+// block and 0 on all other cells, so placing and removing a block writes a
+// single cell. get_cell_tile gives the size of the tile covering any cell.
+// occupancy holds one bit per cell, n_row_words words per row, and is
+// used for every fit and conflict check
+typedef struct puzzle_kernel puzzle_kernel;
+
 typedef struct puzzle_def {
     int size;
     int grid_dimension;
+    // set by init_puzzle, see get_puzzle_kernel
+    puzzle_kernel const* kernel;
     int** puzzle_grid;
     dynarr_head* blocks;
+
+    // tile size of every cell, rebuilt from puzzle_grid by get_cell_tile
+    // after the board has changed
+    int* cell_tiles;
+    bool is_cell_tiles_valid;
+    // tiles covering the top left, top right, bottom left and bottom right
+    // cell, 0 while the corner is empty
+    int corner_tiles[4];
+
+    int n_row_words;
+    uint64_t* occupancy;
+
+    // maintained by place_block/remove_block
+    // the cursor is the first empty cell in row-major order,
+    // cursor_y == grid_dimension once the grid is full
+    int n_filled_cells;
+    int* row_fill;
+    int cursor_x;
+    int cursor_y;
+
+    // skyline: column_height[x] is the number of filled cells from the top
+    // of column x without a hole, skyline holds the run-length segments of
+    // column_height from left to right
+    int* column_height;
+    skyline_segment* skyline;
+    int n_segments;
+    // sum of column_height, below n_filled_cells while a block sits below
+    // the skyline, which only the dlx engine does
+    int n_skyline_cells;
+
+    // Zobrist hash of the column heights and the free piece counts,
+    // the heights fully describe a board without holes
+    uint64_t state_hash;
+
+    // allocated on first use of get_reachable_sums
+    subset_sum_entry* sums_cache;
 } puzzle_def;
 
 typedef enum RETURN_CODES {
@@ -23,9 +94,37 @@ typedef enum RETURN_CODES {
     CONFLICTING_BLOCK_TYPES
 } RETURN_CODES;
 
+// Fit, place and remove functions of one puzzle size
+// Sizes 8-12 get kernels built with the grid dimension and the words per
+// row as compile time constants, so their bounds fold and their row loops
+// unroll. Every other size uses the generic kernel, which reads both from
+// the puzzle. The functions below dispatch through puzzle->kernel.
+struct puzzle_kernel {
+    bool (*placement_resolvable)(puzzle_def* puzzle,
+                                 int block_id,
+                                 int x_pos,
+                                 int y_pos);
+    int (*get_max_fit)(puzzle_def* puzzle, int x_pos, int y_pos);
+    RETURN_CODES (*place_block)(puzzle_def* puzzle,
+                                int block_id,
+                                int x_pos,
+                                int y_pos);
+    RETURN_CODES (*remove_block)(puzzle_def* puzzle,
+                                 int block_id,
+                                 int x_pos,
+                                 int y_pos);
+};
+
+puzzle_kernel const* get_puzzle_kernel(int size);
+
 // Only size is expected to be set
 // size := dimension of the larges tile
 void init_puzzle(puzzle_def* puzzle);
+void free_puzzle(puzzle_def* puzzle);
+// dest is expected to be zeroed, it receives its own grid and blocks
+void copy_puzzle(puzzle_def* dest, puzzle_def* src);
+// Recomputes state_hash, only needed if free_pieces are set by hand
+void reset_state_hash(puzzle_def* puzzle);
 
 RETURN_CODES place_block(puzzle_def* puzzle,
                          int block_id,
@@ -38,11 +137,41 @@ RETURN_CODES remove_block(puzzle_def* puzzle,
 
 int get_n_available_pieces(puzzle_def* puzzle, int block_id);
 
+// Bitset of all sums that can be built from the remaining pieces while
+// respecting the free piece count of every size
+void get_reachable_sums(puzzle_def* puzzle, uint64_t* sums);
+bool is_reachable_sum(uint64_t const* sums, int value);
+
 bool placement_resolvable(puzzle_def* puzzle,
                           int block_id,
                           int x_pos,
                           int y_pos);
+// Side of the largest square, at most the largest tile, that fits with its
+// top left corner on the cell, 0 if the cell is taken
+int get_max_fit(puzzle_def* puzzle, int x_pos, int y_pos);
+// Mask of the tiles up to max_fit, bit i - 1 stands for tile i
+#define FIT_TILES(max_fit) ((uint16_t)((1U << (max_fit)) - 1))
 bool is_puzzle_solved(puzzle_def* puzzle);
+bool get_first_empty_cell(puzzle_def* puzzle, int* x_pos, int* y_pos);
+bool is_cell_occupied(puzzle_def* puzzle, int x_pos, int y_pos);
+// Size of the tile covering the cell, 0 if it is empty
+int get_cell_tile(puzzle_def* puzzle, int x_pos, int y_pos);
+uint64_t* get_occupancy_row(puzzle_def* puzzle, int y_pos);
+
+// Symmetries of the square grid
+// transform bit 2: transpose, bit 0: mirror x, bit 1: mirror y
+#define N_SYMMETRIES 8
+void transform_cell(int transform, int grid_size, int* x_pos, int* y_pos);
+int get_transformed_tile(puzzle_def* puzzle,
+                         int transform,
+                         int x_pos,
+                         int y_pos);
+int compare_transforms(puzzle_def* puzzle, int transform_a, int transform_b);
+// Canonical form of a solved board: its lexicographically smallest
+// transform, shared by all of its rotated and mirrored copies
+int get_canonical_transform(puzzle_def* puzzle);
+// 64 bit hash of the tiles of the canonical form
+uint64_t get_canonical_fingerprint(puzzle_def* puzzle);
 
 void print_grid(puzzle_def* puzzle, FILE* file_ptr);
 void print_free_pieces(puzzle_def* puzzle, FILE* file_ptr);
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <elhaylib.h>
+
+// xoshiro256** by Blackman and Vigna
+// Every solver owns its own state, so a run is reproducible from its seed
+// and independent of other users of rand()
+typedef struct {
+    uint64_t s[4];
+} rng_state;
+
+// The seed is expanded with splitmix64, any value including 0 is fine
+void rng_seed(rng_state* rng, uint64_t seed);
+uint64_t rng_next(rng_state* rng);
+// Uniform in [0, n), n > 0
+int rng_below(rng_state* rng, int n);
+// Index of a uniformly chosen set bit of mask, mask != 0
+int rng_select_bit(rng_state* rng, uint16_t mask);
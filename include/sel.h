@@ -0,0 +1,34 @@
+#pragma once
+
+#include <elhaylib.h>
+#include <puz.h>
+#include <rng.h>
+
+// Tile selection strategies
+// A strategy picks the next tile to try on the current board from the mask
+// of untried tiles, bit i - 1 stands for tile i and at least one bit is
+// set. The built-in strategies only look at the mask and the free pieces,
+// they neither loop over empty bits nor allocate.
+typedef int (*SELECT_F_PTR)(puzzle_def* puzzle,
+                            uint16_t valid_tiles,
+                            void* ctx);
+
+typedef enum {
+    // uniform over the untried tiles, ctx is the rng_state*
+    SELECT_RANDOM,
+    SELECT_LARGEST,
+    SELECT_SMALLEST,
+    // the tile with the most free pieces left, ties go to the larger tile
+    SELECT_MOST_PIECES,
+    N_SELECT_STRATEGIES
+} SELECT_STRATEGY;
+
+int sel_random(puzzle_def* puzzle, uint16_t valid_tiles, void* ctx);
+int sel_largest(puzzle_def* puzzle, uint16_t valid_tiles, void* ctx);
+int sel_smallest(puzzle_def* puzzle, uint16_t valid_tiles, void* ctx);
+int sel_most_pieces(puzzle_def* puzzle, uint16_t valid_tiles, void* ctx);
+
+SELECT_F_PTR sel_func(SELECT_STRATEGY strategy);
+char const* sel_name(SELECT_STRATEGY strategy);
+// Returns false if name is no strategy
+bool sel_parse(char const* name, SELECT_STRATEGY* strategy);
@@ -16,6 +16,43 @@ typedef struct {
     int y_index;
 } point;
 
+// Rules that reject a board as unsolvable, enabled as a bit mask of
+// PRUNE_MASK(rule) and checked in order
+typedef enum PRUNE_RULE {
+    NO_PRUNE,
+    GAP_PRUNE,
+    SUBSET_SUM_PRUNE,
+    N_PRUNE_RULES
+} PRUNE_RULE;
+
+#define PRUNE_MASK(rule) (1 << (rule))
+#define DEFAULT_PRUNE_RULES \
+    (PRUNE_MASK(GAP_PRUNE) | PRUNE_MASK(SUBSET_SUM_PRUNE))
+
+// Restarts
+// The first solution search is restarted with a fresh random tile order
+// whenever its node budget runs out. The budget of the i-th run is
+// base * luby(i) or base * RESTART_GEOMETRIC_FACTOR^(i - 1)
+typedef enum RESTART_STRATEGY {
+    RESTART_NONE,
+    RESTART_LUBY,
+    RESTART_GEOMETRIC
+} RESTART_STRATEGY;
+
+#define RESTART_DEFAULT_BASE 10000
+#define RESTART_GEOMETRIC_FACTOR 1.5
+
+// the bool valid_tiles[] array describes all the tiles
+// that have been attempted as children
+// if it is exhausted then the tree descent has to move
+// to the parent of the selected node
+typedef struct {
+    uint8_t tile_type;
+    uint8_t x_pos;
+    uint8_t y_pos;
+    uint16_t valid_tiles;
+} node_placement;
+
 typedef void (*VIS_F_PTR)(int);
 typedef void (*VIS_SET_F_PTR)(int, int, int);
 typedef void (*VIS_SET_C_PTR)(int*, int);
@@ -29,3 +66,32 @@ void set_visualizer(VIS_F_PTR grid_prep_func_in,
                     VIS_SET_F_PTR block_remove_func_in,
                     VIS_SET_C_PTR block_set_color_func_in);
 bool solution_search();
+
+// restart >= 1
+uint64_t restart_budget(RESTART_STRATEGY strategy,
+                        uint64_t base,
+                        int restart);
+char const* restart_strategy_name(RESTART_STRATEGY strategy);
+
+bool line_scan_hor(puzzle_def* puzzle, point* result);
+bool find_smallest_gap(puzzle_def* puzzle, gap_search_result* res_struct);
+bool is_solvable_gap_cond(puzzle_def* puzzle);
+bool is_solvable_subset_sum(puzzle_def* puzzle);
+PRUNE_RULE check_prune_rules(puzzle_def* puzzle, int prune_rules);
+char const* prune_rule_name(PRUNE_RULE rule);
+
+// Symmetry breaking
+// Of the 8 symmetric copies of a tiling only those are explored whose
+// corner tiles are ordered: top left <= top right <= bottom left and
+// top left <= bottom right
+bool is_symmetry_allowed(puzzle_def* puzzle,
+                         int block_id,
+                         int x_pos,
+                         int y_pos);
+bool has_ordered_corners(puzzle_def* puzzle, int transform);
+// n_copies: distinct symmetric copies of the solved board
+// is_unique: the board is the smallest of its copies the search can reach
+void classify_solution(puzzle_def* puzzle,
+                       bool break_symmetry,
+                       bool* is_unique,
+                       int* n_copies);
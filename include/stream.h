@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdio.h>
+
+#include <elhaylib.h>
+#include <sol.h>
+
+// Binary solution stream
+// Every solution is stored as its list of placements in the order the
+// search placed them. Solutions found one after another share most of their
+// DFS prefix, so a record only holds the number of placements it shares
+// with the previous record and the placements after them:
+//   uint8 n_shared, (n_placements - n_shared) x {uint8 tile, x, y}
+// Every STREAM_KEYFRAME_PERIOD-th record is written in full (n_shared = 0),
+// an index of their offsets at the end of the file allows random access.
+// Layout: 32 byte header, records, padding to 8 bytes, keyframe index.
+// Numbers are written in the byte order of the machine, like checkpoints.
+#define STREAM_MAGIC "PPSOLS"
+#define STREAM_VERSION 1
+#define STREAM_HEADER_SIZE 32
+#define STREAM_KEYFRAME_PERIOD 1024
+#define STREAM_BUFFER_SIZE (1 << 16)
+// a puzzle of type 16 has 136 pieces on a 136 wide grid, which still fits
+// into the uint8 fields of a record
+#define STREAM_MAX_PLACEMENTS 255
+
+typedef struct {
+    FILE* file_ptr;
+    char* buffer;
+    int puzzle_type;
+    int n_placements;
+    uint64_t n_solutions;
+    // bytes written so far, i.e. the offset of the next record
+    uint64_t offset;
+    // the last written solution
+    node_placement* previous;
+    // set once a record could not be written, e.g. on a full disk, the
+    // offsets of all later records would be wrong
+    bool is_failed;
+    // uint64_t offsets of the keyframe records
+    dynarr_head keyframes;
+} stream_writer;
+
+// Returns false if the file cannot be created
+bool stream_open(stream_writer* writer, char const* path, int puzzle_type);
+// placements holds the n_placements placements of a solved board
+void stream_write(stream_writer* writer, node_placement const* placements);
+// Writes the keyframe index and the solution count into the header, a
+// stream that was never closed can still be iterated but not searched.
+// Returns false if any write failed, the header is then left as it was
+bool stream_close(stream_writer* writer);
+
+// The file is mapped read-only, records are decoded in place
+typedef struct {
+    uint8_t const* data;
+    size_t size;
+    int puzzle_type;
+    int n_placements;
+    // 0 if the stream was not closed
+    uint64_t n_solutions;
+    uint8_t const* records;
+    uint8_t const* records_end;
+    // NULL if the stream was not closed
+    uint64_t const* keyframes;
+    uint64_t n_keyframes;
+} stream_reader;
+
+typedef struct {
+    stream_reader const* reader;
+    // the next record and its solution number
+    uint8_t const* next;
+    uint64_t n_read;
+    // the last decoded solution, n_placements entries
+    node_placement* placements;
+} stream_cursor;
+
+// Returns false if the file is missing or not a solution stream
+bool stream_map(stream_reader* reader, char const* path);
+void stream_unmap(stream_reader* reader);
+
+void stream_cursor_init(stream_cursor* cursor, stream_reader const* reader);
+// Decodes the next solution into cursor->placements, false at the end
+bool stream_next(stream_cursor* cursor);
+// The next call to stream_next decodes solution index, at most
+// STREAM_KEYFRAME_PERIOD - 1 records are decoded to get there
+bool stream_seek(stream_cursor* cursor, uint64_t index);
+void stream_cursor_free(stream_cursor* cursor);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <elhaylib.h>
+#include <sol.h>
+
+#define TELEM_DEFAULT_INTERVAL 10
+// iterations of the classic search between two looks at the clock
+#define TELEM_CHECK_PERIOD 4096
+#define TELEM_MAX_CLIENTS 8
+#define TELEM_BUFFER_SIZE 4096
+
+// Live telemetry of a running search
+// A snapshot of the counters is published every interval seconds, on
+// SIGUSR1 and whenever a client connects to the socket. It is written as
+// "key value" lines like --stats, to a file that is replaced atomically
+// and/or to every client of a local Unix stream socket, which is closed
+// after the snapshot, e.g. socat - UNIX-CONNECT:PATH. The search only
+// calls telem_is_due every few thousand nodes, so the hot loop stays as it
+// is. The socket is not available on Windows, neither is SIGUSR1.
+typedef struct {
+    char const* mode;
+    int puzzle_type;
+    uint64_t seed;
+    uint64_t n_nodes;
+    int depth;
+    int deepest_depth;
+    uint64_t n_backtracks;
+    // N_PRUNE_RULES entries, only the rules of prune_rules are reported
+    uint64_t const* prune_hits;
+    int prune_rules;
+    size_t tree_size;
+} telem_snapshot;
+
+typedef struct {
+    // both optional
+    char const* path;
+    char const* socket_path;
+    double interval;
+
+    int listen_fd;
+    int clients[TELEM_MAX_CLIENTS];
+    int n_clients;
+
+    double begin;
+    double next_due;
+    // the rate is taken over the time since the last snapshot
+    double last_time;
+    uint64_t last_nodes;
+    uint64_t n_published;
+    char buffer[TELEM_BUFFER_SIZE];
+} telem_state;
+
+// Returns false if the socket cannot be created
+bool telem_open(telem_state* telem,
+                char const* path,
+                char const* socket_path,
+                double interval);
+// True if the interval is over, SIGUSR1 arrived or a client waits
+bool telem_is_due(telem_state* telem);
+void telem_publish(telem_state* telem, telem_snapshot const* snapshot);
+// Removes the socket, the file is kept with the last snapshot
+void telem_close(telem_state* telem);
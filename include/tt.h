@@ -0,0 +1,49 @@
+#pragma once
+
+#include <elhaylib.h>
+#include <puz.h>
+#include <stdatomic.h>
+
+#define TT_KEY_MASK (~(uint64_t)0xFF)
+#define TT_MAX_PRIORITY 0xFF
+
+// Transposition table of dead states
+// Different placement orders reach the same board: the same column
+// heights with the same remaining pieces. Once such a board has been
+// searched without a solution it is stored here and every later visit is
+// cut off. The table has a fixed number of slots, a power of two, and
+// every slot is a single 64 bit word: the upper 56 bits of the state key
+// and the number of remaining pieces in the lowest byte. The pieces left
+// are the priority of an entry, a board with more pieces left stands for
+// a larger subtree. A word is read and written atomically, so the table
+// can be shared by the workers of the parallel search.
+typedef enum {
+    // a new entry always takes the slot
+    TT_REPLACE_ALWAYS,
+    // a new entry only takes the slot from one with fewer pieces left
+    TT_REPLACE_LARGER
+} TT_POLICY;
+
+typedef struct {
+    _Atomic uint64_t* slots;
+    size_t n_slots;
+    TT_POLICY policy;
+
+    atomic_uint_fast64_t n_stores;
+    atomic_uint_fast64_t n_replaced;
+    atomic_uint_fast64_t n_rejected;
+} tt_table;
+
+// size_mb is rounded down to a power of two number of slots
+void tt_init(tt_table* table, size_t size_mb, TT_POLICY policy);
+void tt_free(tt_table* table);
+
+// With symmetry breaking the corner tiles restrict the placements, so
+// they become part of the key
+uint64_t tt_state_key(puzzle_def* puzzle, bool break_symmetry);
+bool tt_probe(tt_table* table, uint64_t key);
+void tt_store(tt_table* table, uint64_t key, int n_remaining);
+
+int tt_remaining_pieces(puzzle_def* puzzle);
+size_t tt_n_used(tt_table* table);
+char const* tt_policy_name(TT_POLICY policy);
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #define TESTING
 
 typedef enum {
@@ -31,4 +34,41 @@ void set_vis_block_color(int block_size, COLOR color, int x_pos, int y_pos);
 void remove_vis_block(int block_size, int x_pos, int y_pos);
 
 void def_block_colors(int* in_block_colors, int size);
-COLOR get_block_color(int block_size);
\ No newline at end of file
+COLOR get_block_color(int block_size);
+
+// Frame renderer
+// back holds the next frame and front what the terminal shows, one color
+// per cell. A flush only redraws the cells that differ, runs of changed
+// cells with the same color share one color sequence, and the frame goes
+// out with a single write. The cursor stays on the top left cell.
+#define VIS_CELL_EMPTY 0xFFFF
+#define VIS_CELL_UNKNOWN 0xFFFE
+
+typedef struct {
+    int size;
+    uint16_t* front;
+    uint16_t* back;
+    char* out;
+    size_t out_len;
+    size_t out_capacity;
+} vis_frame;
+
+void vis_frame_init(vis_frame* frame, int size);
+void vis_frame_free(vis_frame* frame);
+// Empties the back buffer
+void vis_frame_clear(vis_frame* frame);
+void vis_frame_set_block(vis_frame* frame,
+                         int block_size,
+                         COLOR color,
+                         int x_pos,
+                         int y_pos);
+// Returns the number of bytes written
+size_t vis_frame_flush(vis_frame* frame);
+
+// The frame renderer behind the visualizer callbacks, the first prep
+// reserves the lines of the grid, every further prep starts a new frame
+void prep_vis_frame(int size);
+void render_vis_frame(int size);
+void reset_vis_frame(int size);
+void set_vis_frame_block(int block_size, int x_pos, int y_pos);
+void remove_vis_frame_block(int block_size, int x_pos, int y_pos);
\ No newline at end of file
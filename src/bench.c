@@ -0,0 +1,449 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <elhaylib.h>
+
+// Benchmark harness
+// Runs the solver binary for every combination of puzzle size, seed and
+// option set, repeat times each. The solver reports its search time and
+// node count through --stats, the CPU time and the peak RSS of the whole
+// process are taken from wait4(). The results are written as JSON or CSV,
+// a summary with the medians of every case goes to stderr.
+#define BENCH_MAX_LIST 64
+#define BENCH_MAX_ARGS 64
+#define BENCH_POLL_NS 5000000L
+
+typedef enum { BENCH_JSON, BENCH_CSV } BENCH_FORMAT;
+
+typedef struct {
+    char const* solver;
+    int sizes[BENCH_MAX_LIST];
+    int n_sizes;
+    uint64_t seeds[BENCH_MAX_LIST];
+    int n_seeds;
+    char const* options[BENCH_MAX_LIST];
+    int n_options;
+    int repeats;
+    double timeout;
+    BENCH_FORMAT format;
+    char const* out_path;
+} bench_config;
+
+typedef struct {
+    int size;
+    uint64_t seed;
+    char const* options;
+    int repeat;
+
+    int exit_code;
+    bool timed_out;
+    bool has_stats;
+    char mode[32];
+    bool is_solved;
+    uint64_t n_nodes;
+    uint64_t n_solutions;
+    size_t tree_size;
+    // search time reported by the solver
+    double wall_time;
+    // whole process, from wait4
+    double process_time;
+    double cpu_time;
+    long peak_rss_kb;
+} bench_result;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double timeval_seconds(struct timeval tv) {
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+}
+
+static void read_stats(char const* path, bench_result* result) {
+    FILE* stats_fptr = fopen(path, "r");
+    if(!stats_fptr) {
+        return;
+    }
+
+    char key[32];
+    char value[32];
+    while(fscanf(stats_fptr, "%31s %31s", key, value) == 2) {
+        result->has_stats = true;
+        if(strcmp(key, "mode") == 0) {
+            snprintf(result->mode, sizeof(result->mode), "%s", value);
+        } else if(strcmp(key, "solved") == 0) {
+            result->is_solved = strtol(value, NULL, 10) != 0;
+        } else if(strcmp(key, "nodes") == 0) {
+            result->n_nodes = strtoull(value, NULL, 10);
+        } else if(strcmp(key, "solutions") == 0) {
+            result->n_solutions = strtoull(value, NULL, 10);
+        } else if(strcmp(key, "tree_size") == 0) {
+            result->tree_size = (size_t)strtoull(value, NULL, 10);
+        } else if(strcmp(key, "wall_time") == 0) {
+            result->wall_time = strtod(value, NULL);
+        }
+    }
+    fclose(stats_fptr);
+}
+
+// Splits options on spaces into argv, buffer receives the words
+static int split_options(char const* options,
+                         char* buffer,
+                         size_t buffer_size,
+                         char** argv,
+                         int max_args) {
+    snprintf(buffer, buffer_size, "%s", options);
+    int n_args = 0;
+    char* save_ptr = NULL;
+    for(char* word = strtok_r(buffer, " ", &save_ptr);
+        word && n_args < max_args; word = strtok_r(NULL, " ", &save_ptr)) {
+        argv[n_args++] = word;
+    }
+    return n_args;
+}
+
+static void run_case(bench_config const* config, bench_result* result) {
+    char stats_path[] = "/tmp/partridge_bench_XXXXXX";
+    int stats_fd = mkstemp(stats_path);
+    if(stats_fd < 0) {
+        perror("mkstemp failed");
+        exit(EXIT_FAILURE);
+    }
+    close(stats_fd);
+
+    char size_arg[16];
+    char seed_arg[32];
+    snprintf(size_arg, sizeof(size_arg), "%d", result->size);
+    snprintf(seed_arg, sizeof(seed_arg), "%" PRIu64, result->seed);
+
+    char option_buffer[1024];
+    char* argv[BENCH_MAX_ARGS + 8];
+    int argc = 0;
+    argv[argc++] = (char*)config->solver;
+    argv[argc++] = size_arg;
+    argv[argc++] = "--seed";
+    argv[argc++] = seed_arg;
+    argv[argc++] = "--stats";
+    argv[argc++] = stats_path;
+    argc += split_options(result->options, option_buffer,
+                          sizeof(option_buffer), &argv[argc], BENCH_MAX_ARGS);
+    argv[argc] = NULL;
+
+    double begin = now_seconds();
+    pid_t pid = fork();
+    if(pid < 0) {
+        perror("fork failed");
+        exit(EXIT_FAILURE);
+    }
+    if(pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        if(null_fd >= 0) {
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+            close(null_fd);
+        }
+        execv(config->solver, argv);
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage = {0};
+    struct timespec poll = {0, BENCH_POLL_NS};
+    while(true) {
+        pid_t done = wait4(pid, &status, WNOHANG, &usage);
+        if(done == pid || (done < 0 && errno != EINTR)) {
+            break;
+        }
+        if(config->timeout > 0 && now_seconds() - begin > config->timeout) {
+            kill(pid, SIGKILL);
+            wait4(pid, &status, 0, &usage);
+            result->timed_out = true;
+            break;
+        }
+        nanosleep(&poll, NULL);
+    }
+
+    result->process_time = now_seconds() - begin;
+    result->cpu_time =
+        timeval_seconds(usage.ru_utime) + timeval_seconds(usage.ru_stime);
+    // kilobytes on Linux
+    result->peak_rss_kb = usage.ru_maxrss;
+    result->exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
+    if(!result->timed_out) {
+        read_stats(stats_path, result);
+    }
+    remove(stats_path);
+}
+
+static double nodes_per_sec(bench_result const* result) {
+    return result->wall_time > 0 ? result->n_nodes / result->wall_time : 0;
+}
+
+static void print_json_string(FILE* file_ptr, char const* str) {
+    fputc('"', file_ptr);
+    for(; *str; ++str) {
+        if(*str == '"' || *str == '\\') {
+            fputc('\\', file_ptr);
+        }
+        fputc(*str, file_ptr);
+    }
+    fputc('"', file_ptr);
+}
+
+static void print_json(FILE* file_ptr, bench_result const* results, int n) {
+    fprintf(file_ptr, "[\n");
+    for(int i = 0; i < n; ++i) {
+        bench_result const* result = &results[i];
+        fprintf(file_ptr, "  {\"size\": %d, \"seed\": %" PRIu64 ", ",
+                result->size, result->seed);
+        fprintf(file_ptr, "\"options\": ");
+        print_json_string(file_ptr, result->options);
+        fprintf(file_ptr, ", \"repeat\": %d, \"mode\": ", result->repeat);
+        print_json_string(file_ptr, result->mode);
+        fprintf(file_ptr,
+                ", \"exit_code\": %d, \"timed_out\": %s, \"solved\": %s, "
+                "\"nodes\": %" PRIu64 ", \"solutions\": %" PRIu64
+                ", \"tree_size\": %zu, \"wall_time\": %f, "
+                "\"process_time\": %f, \"cpu_time\": %f, "
+                "\"nodes_per_sec\": %.0f, \"peak_rss_kb\": %ld}%s\n",
+                result->exit_code, result->timed_out ? "true" : "false",
+                result->is_solved ? "true" : "false", result->n_nodes,
+                result->n_solutions, result->tree_size, result->wall_time,
+                result->process_time, result->cpu_time,
+                nodes_per_sec(result), result->peak_rss_kb,
+                i + 1 < n ? "," : "");
+    }
+    fprintf(file_ptr, "]\n");
+}
+
+static void print_csv(FILE* file_ptr, bench_result const* results, int n) {
+    fprintf(file_ptr,
+            "size,seed,options,repeat,mode,exit_code,timed_out,solved,nodes,"
+            "solutions,tree_size,wall_time,process_time,cpu_time,"
+            "nodes_per_sec,peak_rss_kb\n");
+    for(int i = 0; i < n; ++i) {
+        bench_result const* result = &results[i];
+        fprintf(file_ptr,
+                "%d,%" PRIu64 ",\"%s\",%d,%s,%d,%d,%d,%" PRIu64 ",%" PRIu64
+                ",%zu,%f,%f,%f,%.0f,%ld\n",
+                result->size, result->seed, result->options, result->repeat,
+                result->mode, result->exit_code, result->timed_out ? 1 : 0,
+                result->is_solved ? 1 : 0, result->n_nodes,
+                result->n_solutions, result->tree_size, result->wall_time,
+                result->process_time, result->cpu_time,
+                nodes_per_sec(result), result->peak_rss_kb);
+    }
+}
+
+static int compare_doubles(void const* a, void const* b) {
+    double lhs = *(double const*)a;
+    double rhs = *(double const*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static double median(double* values, int n) {
+    qsort(values, (size_t)n, sizeof(double), compare_doubles);
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+// The repeats of a case are stored next to each other
+static void print_summary(bench_result const* results,
+                          int n_results,
+                          int repeats) {
+    double* wall_times = calloc((size_t)repeats, sizeof(double));
+    double* rates = calloc((size_t)repeats, sizeof(double));
+    if(!wall_times || !rates) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    for(int i = 0; i < n_results; i += repeats) {
+        int n_solved = 0;
+        long peak_rss_kb = 0;
+        for(int j = 0; j < repeats; ++j) {
+            bench_result const* result = &results[i + j];
+            wall_times[j] = result->timed_out ? result->process_time
+                                              : result->wall_time;
+            rates[j] = nodes_per_sec(result);
+            n_solved += result->is_solved;
+            if(result->peak_rss_kb > peak_rss_kb) {
+                peak_rss_kb = result->peak_rss_kb;
+            }
+        }
+
+        bench_result const* first = &results[i];
+        fprintf(stderr,
+                "size %d - seed %" PRIu64 " - options \"%s\": solved %d/%d "
+                "- median wall %f s - median nodes/sec %.0f - peak RSS %ld "
+                "kB\n",
+                first->size, first->seed, first->options, n_solved, repeats,
+                median(wall_times, repeats), median(rates, repeats),
+                peak_rss_kb);
+    }
+
+    free(wall_times);
+    free(rates);
+}
+
+static int parse_list(char const* arg, uint64_t* values, int max_values) {
+    int n_values = 0;
+    char const* ptr = arg;
+    while(*ptr && n_values < max_values) {
+        char* end_ptr = NULL;
+        values[n_values++] = strtoull(ptr, &end_ptr, 10);
+        if(end_ptr == ptr) {
+            return -1;
+        }
+        ptr = *end_ptr == ',' ? end_ptr + 1 : end_ptr;
+        if(*end_ptr != ',' && *end_ptr != '\0') {
+            return -1;
+        }
+    }
+    return n_values;
+}
+
+static void print_usage() {
+    printf(
+        "Usage: ./bench.out {--solver PATH} {--sizes 8,9} {--seeds 1,2,3} "
+        "{--options \"...\"}... {--repeats N} {--timeout SEC} "
+        "{--format json/csv} {--out FILE}\n"
+        "Defaults: --solver ./sol_prod.out --sizes 8 --seeds 1,2,3 "
+        "--options \"\" --options \"--restart luby\" --options \"--tt 64\" "
+        "--repeats 3 --timeout 60 --format json\n");
+}
+
+static void handle_input(int argc, char** argv, bench_config* config) {
+    for(int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        uint64_t values[BENCH_MAX_LIST];
+        int n_values = 0;
+        if(strcmp(argv[i], "-h") == 0) {
+            print_usage();
+            exit(EXIT_SUCCESS);
+        } else if(strcmp(argv[i], "--solver") == 0 && has_value) {
+            config->solver = argv[++i];
+        } else if(strcmp(argv[i], "--sizes") == 0 && has_value &&
+                  (n_values = parse_list(argv[++i], values,
+                                         BENCH_MAX_LIST)) > 0) {
+            config->n_sizes = n_values;
+            for(int j = 0; j < n_values; ++j) {
+                config->sizes[j] = (int)values[j];
+            }
+        } else if(strcmp(argv[i], "--seeds") == 0 && has_value &&
+                  (n_values = parse_list(argv[++i], values,
+                                         BENCH_MAX_LIST)) > 0) {
+            config->n_seeds = n_values;
+            memcpy(config->seeds, values, sizeof(uint64_t) * n_values);
+        } else if(strcmp(argv[i], "--options") == 0 && has_value &&
+                  config->n_options < BENCH_MAX_LIST) {
+            // the first --options replaces the default sets
+            static bool is_default = true;
+            if(is_default) {
+                config->n_options = 0;
+                is_default = false;
+            }
+            config->options[config->n_options++] = argv[++i];
+        } else if(strcmp(argv[i], "--repeats") == 0 && has_value &&
+                  (config->repeats = atoi(argv[++i])) > 0) {
+            continue;
+        } else if(strcmp(argv[i], "--timeout") == 0 && has_value) {
+            config->timeout = strtod(argv[++i], NULL);
+        } else if(strcmp(argv[i], "--format") == 0 && has_value &&
+                  (strcmp(argv[i + 1], "json") == 0 ||
+                   strcmp(argv[i + 1], "csv") == 0)) {
+            config->format =
+                strcmp(argv[++i], "json") == 0 ? BENCH_JSON : BENCH_CSV;
+        } else if(strcmp(argv[i], "--out") == 0 && has_value) {
+            config->out_path = argv[++i];
+        } else {
+            printf("Command Line argument not recognized or invalid: %s\n",
+                   argv[i]);
+            print_usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bench_config config = {0};
+    config.solver = "./sol_prod.out";
+    config.sizes[config.n_sizes++] = 8;
+    for(int seed = 1; seed <= 3; ++seed) {
+        config.seeds[config.n_seeds++] = (uint64_t)seed;
+    }
+    config.options[config.n_options++] = "";
+    config.options[config.n_options++] = "--restart luby";
+    config.options[config.n_options++] = "--tt 64";
+    config.repeats = 3;
+    config.timeout = 60;
+    config.format = BENCH_JSON;
+
+    handle_input(argc, argv, &config);
+
+    if(access(config.solver, X_OK) != 0) {
+        printf("Solver binary not found: %s (build it with make sol_prod)\n",
+               config.solver);
+        return EXIT_FAILURE;
+    }
+
+    int n_results =
+        config.n_sizes * config.n_seeds * config.n_options * config.repeats;
+    bench_result* results = calloc((size_t)n_results, sizeof(bench_result));
+    if(!results) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    int n_done = 0;
+    for(int i = 0; i < config.n_sizes; ++i) {
+        for(int j = 0; j < config.n_seeds; ++j) {
+            for(int k = 0; k < config.n_options; ++k) {
+                for(int repeat = 0; repeat < config.repeats; ++repeat) {
+                    bench_result* result = &results[n_done++];
+                    result->size = config.sizes[i];
+                    result->seed = config.seeds[j];
+                    result->options = config.options[k];
+                    result->repeat = repeat;
+                    fprintf(stderr, "\33[2K\rRun %d/%d", n_done, n_results);
+                    run_case(&config, result);
+                }
+            }
+        }
+    }
+    fprintf(stderr, "\33[2K\r");
+
+    FILE* out_fptr = stdout;
+    if(config.out_path) {
+        out_fptr = fopen(config.out_path, "w");
+        if(!out_fptr) {
+            perror("fopen failed");
+            return EXIT_FAILURE;
+        }
+    }
+    if(config.format == BENCH_JSON) {
+        print_json(out_fptr, results, n_results);
+    } else {
+        print_csv(out_fptr, results, n_results);
+    }
+    if(out_fptr != stdout) {
+        fclose(out_fptr);
+    }
+
+    print_summary(results, n_results, config.repeats);
+    free(results);
+
+    return EXIT_SUCCESS;
+}
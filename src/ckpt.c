@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ckpt.h>
+#include <fileio.h>
+
+// The fields are written one by one, so the file has no struct padding
+#define CKPT_WRITE(field) fwrite(&(field), sizeof(field), 1, file_ptr)
+#define CKPT_READ(field) fread(&(field), sizeof(field), 1, file_ptr)
+
+bool ckpt_write(char const* path, checkpoint const* ckpt) {
+    file_replace file;
+    if(!file_replace_open(&file, path, "wb")) {
+        perror("checkpoint open failed");
+        return false;
+    }
+    FILE* file_ptr = file.file_ptr;
+
+    uint32_t version = CKPT_VERSION;
+    size_t n_written = fwrite(CKPT_MAGIC, sizeof(CKPT_MAGIC), 1, file_ptr);
+    n_written += CKPT_WRITE(version);
+    n_written += CKPT_WRITE(ckpt->mode);
+    n_written += CKPT_WRITE(ckpt->puzzle_type);
+    n_written += CKPT_WRITE(ckpt->prune_rules);
+    n_written += CKPT_WRITE(ckpt->break_symmetry);
+    n_written += CKPT_WRITE(ckpt->select_strategy);
+    n_written += CKPT_WRITE(ckpt->seed);
+    n_written += CKPT_WRITE(ckpt->rng);
+    n_written += CKPT_WRITE(ckpt->n_iterations);
+    n_written += CKPT_WRITE(ckpt->n_pruned_nodes);
+    n_written += CKPT_WRITE(ckpt->tt_hits);
+    n_written += CKPT_WRITE(ckpt->tt_misses);
+    n_written += CKPT_WRITE(ckpt->prune_hits);
+    n_written += CKPT_WRITE(ckpt->cpu_time);
+    n_written += CKPT_WRITE(ckpt->n_backtracks);
+    n_written += CKPT_WRITE(ckpt->deepest_depth);
+    n_written += CKPT_WRITE(ckpt->n_solutions);
+    n_written += CKPT_WRITE(ckpt->n_unique_solutions);
+    n_written += CKPT_WRITE(ckpt->n_raw_solutions);
+    n_written += CKPT_WRITE(ckpt->free_pieces);
+    n_written += CKPT_WRITE(ckpt->path_depth);
+    size_t n_fields = 22;
+    for(int i = 0; i <= ckpt->path_depth; ++i) {
+        // the classic search starts a level with every bit set, the bits
+        // above the largest tile are never looked at
+        uint16_t valid_tiles =
+            ckpt->path[i].valid_tiles & FIT_TILES(ckpt->puzzle_type);
+        n_written += CKPT_WRITE(ckpt->path[i].tile_type);
+        n_written += CKPT_WRITE(ckpt->path[i].x_pos);
+        n_written += CKPT_WRITE(ckpt->path[i].y_pos);
+        n_written += CKPT_WRITE(valid_tiles);
+        n_fields += 4;
+        if(ckpt->mode == CKPT_MODE_ENUMERATE) {
+            n_written += CKPT_WRITE(ckpt->level_solutions[i]);
+            ++n_fields;
+        }
+    }
+
+    if(!file_replace_commit(&file, n_written == n_fields)) {
+        perror("checkpoint write failed");
+        return false;
+    }
+    return true;
+}
+
+bool ckpt_read(char const* path, checkpoint* ckpt) {
+    FILE* file_ptr = fopen(path, "rb");
+    if(!file_ptr) {
+        perror("checkpoint open failed");
+        return false;
+    }
+
+    char magic[sizeof(CKPT_MAGIC)] = {0};
+    uint32_t version = 0;
+    size_t n_read = fread(magic, sizeof(magic), 1, file_ptr);
+    n_read += CKPT_READ(version);
+    if(n_read != 2 || memcmp(magic, CKPT_MAGIC, sizeof(magic)) != 0 ||
+       version != CKPT_VERSION) {
+        fprintf(stderr, "%s is not a checkpoint of this version.\n", path);
+        fclose(file_ptr);
+        return false;
+    }
+
+    n_read = CKPT_READ(ckpt->mode);
+    n_read += CKPT_READ(ckpt->puzzle_type);
+    n_read += CKPT_READ(ckpt->prune_rules);
+    n_read += CKPT_READ(ckpt->break_symmetry);
+    n_read += CKPT_READ(ckpt->select_strategy);
+    n_read += CKPT_READ(ckpt->seed);
+    n_read += CKPT_READ(ckpt->rng);
+    n_read += CKPT_READ(ckpt->n_iterations);
+    n_read += CKPT_READ(ckpt->n_pruned_nodes);
+    n_read += CKPT_READ(ckpt->tt_hits);
+    n_read += CKPT_READ(ckpt->tt_misses);
+    n_read += CKPT_READ(ckpt->prune_hits);
+    n_read += CKPT_READ(ckpt->cpu_time);
+    n_read += CKPT_READ(ckpt->n_backtracks);
+    n_read += CKPT_READ(ckpt->deepest_depth);
+    n_read += CKPT_READ(ckpt->n_solutions);
+    n_read += CKPT_READ(ckpt->n_unique_solutions);
+    n_read += CKPT_READ(ckpt->n_raw_solutions);
+    n_read += CKPT_READ(ckpt->free_pieces);
+    n_read += CKPT_READ(ckpt->path_depth);
+    size_t n_fields = 20;
+
+    int max_depth = (ckpt->puzzle_type * (ckpt->puzzle_type + 1)) / 2;
+    if(n_read != n_fields || ckpt->mode < 0 || ckpt->mode >= N_CKPT_MODES ||
+       ckpt->puzzle_type < 1 ||
+       ckpt->select_strategy < 0 ||
+       ckpt->select_strategy >= N_SELECT_STRATEGIES ||
+       ckpt->puzzle_type > CKPT_MAX_TILE_TYPES || ckpt->path_depth < 0 ||
+       ckpt->path_depth >= max_depth) {
+        fprintf(stderr, "%s is truncated or corrupt.\n", path);
+        fclose(file_ptr);
+        return false;
+    }
+
+    ckpt->path =
+        calloc((size_t)ckpt->path_depth + 1, sizeof(node_placement));
+    ckpt->level_solutions =
+        calloc((size_t)ckpt->path_depth + 1, sizeof(uint64_t));
+    if(!ckpt->path || !ckpt->level_solutions) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // the path is placed on the board as it is read, so every entry has to
+    // be a tile of the puzzle on the grid. Only the last level of an
+    // enumeration may not have a tile placed yet.
+    int grid_size = PUZZLE_GRID_DIMENSION(ckpt->puzzle_type);
+    bool is_valid = true;
+    n_read = 0;
+    n_fields = 0;
+    for(int i = 0; i <= ckpt->path_depth && is_valid; ++i) {
+        node_placement* placement = &ckpt->path[i];
+        n_read += CKPT_READ(placement->tile_type);
+        n_read += CKPT_READ(placement->x_pos);
+        n_read += CKPT_READ(placement->y_pos);
+        n_read += CKPT_READ(placement->valid_tiles);
+        n_fields += 4;
+        if(ckpt->mode == CKPT_MODE_ENUMERATE) {
+            n_read += CKPT_READ(ckpt->level_solutions[i]);
+            ++n_fields;
+        }
+
+        int min_tile = ckpt->mode == CKPT_MODE_ENUMERATE &&
+                               i == ckpt->path_depth
+                           ? 0
+                           : 1;
+        is_valid = placement->tile_type >= min_tile &&
+                   placement->tile_type <= ckpt->puzzle_type &&
+                   placement->x_pos < grid_size &&
+                   placement->y_pos < grid_size &&
+                   (placement->valid_tiles &
+                    ~FIT_TILES(ckpt->puzzle_type)) == 0;
+    }
+    fclose(file_ptr);
+
+    if(n_read != n_fields || !is_valid) {
+        fprintf(stderr, "%s is truncated or corrupt.\n", path);
+        ckpt_free(ckpt);
+        return false;
+    }
+
+    return true;
+}
+
+void ckpt_free(checkpoint* ckpt) {
+    free(ckpt->path);
+    ckpt->path = NULL;
+    free(ckpt->level_solutions);
+    ckpt->level_solutions = NULL;
+}
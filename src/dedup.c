@@ -0,0 +1,312 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <dedup.h>
+#include <fileio.h>
+
+// a puzzle of type 16 is the largest, see handle_input
+#define DEDUP_MAX_GRID_DIMENSION 136
+#define DEDUP_WRITE_BUFFER_SIZE (1 << 16)
+
+static void unmap_file(dedup_set* set) {
+    if(!set->data) {
+        return;
+    }
+#ifdef _WIN32
+    free((void*)set->data);
+#else
+    munmap((void*)set->data, set->size);
+#endif
+    set->data = NULL;
+    set->size = 0;
+    set->sorted = NULL;
+    set->n_sorted = 0;
+}
+
+// Maps the file at set->path, a missing file is an empty set
+static bool map_file(dedup_set* set) {
+    FILE* file_ptr = fopen(set->path, "rb");
+    if(!file_ptr) {
+        return true;
+    }
+
+#ifdef _WIN32
+    // no mmap, the file is read into memory instead
+    fseek(file_ptr, 0, SEEK_END);
+    set->size = (size_t)ftell(file_ptr);
+    fseek(file_ptr, 0, SEEK_SET);
+    uint8_t* data = malloc(set->size + 1);
+    if(!data) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    bool is_read = fread(data, 1, set->size, file_ptr) == set->size;
+    fclose(file_ptr);
+    set->data = data;
+    if(!is_read) {
+        perror("fingerprint set read failed");
+        unmap_file(set);
+        return false;
+    }
+#else
+    struct stat st;
+    if(fstat(fileno(file_ptr), &st) == -1 || st.st_size < DEDUP_HEADER_SIZE) {
+        fprintf(stderr, "%s is not a fingerprint set.\n", set->path);
+        fclose(file_ptr);
+        return false;
+    }
+    set->size = (size_t)st.st_size;
+    void* data =
+        mmap(NULL, set->size, PROT_READ, MAP_PRIVATE, fileno(file_ptr), 0);
+    fclose(file_ptr);
+    if(data == MAP_FAILED) {
+        perror("mmap failed");
+        set->size = 0;
+        return false;
+    }
+    set->data = data;
+#endif
+
+    uint8_t version = 0;
+    uint64_t n_sorted = 0;
+    if(set->size >= DEDUP_HEADER_SIZE) {
+        memcpy(&version, set->data + sizeof(DEDUP_MAGIC), 1);
+        memcpy(&n_sorted, set->data + 8, sizeof(n_sorted));
+    }
+    if(set->size < DEDUP_HEADER_SIZE ||
+       memcmp(set->data, DEDUP_MAGIC, sizeof(DEDUP_MAGIC)) != 0 ||
+       version != DEDUP_VERSION ||
+       set->size != DEDUP_HEADER_SIZE + n_sorted * sizeof(uint64_t)) {
+        fprintf(stderr, "%s is not a fingerprint set of this version.\n",
+                set->path);
+        unmap_file(set);
+        return false;
+    }
+
+    set->sorted = (uint64_t const*)(set->data + DEDUP_HEADER_SIZE);
+    set->n_sorted = (size_t)n_sorted;
+    return true;
+}
+
+static bool is_in_file(dedup_set* set, uint64_t fingerprint) {
+    size_t low = 0;
+    size_t high = set->n_sorted;
+    while(low < high) {
+        size_t mid = low + (high - low) / 2;
+        if(set->sorted[mid] < fingerprint) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < set->n_sorted && set->sorted[low] == fingerprint;
+}
+
+static void insert_slot(uint64_t* slots, size_t n_slots, uint64_t fingerprint) {
+    size_t i = fingerprint & (n_slots - 1);
+    while(slots[i] != 0) {
+        i = (i + 1) & (n_slots - 1);
+    }
+    slots[i] = fingerprint;
+}
+
+static void grow_table(dedup_set* set) {
+    size_t n_slots = set->n_slots * 2;
+    uint64_t* slots = calloc(n_slots, sizeof(uint64_t));
+    if(!slots) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for(size_t i = 0; i < set->n_slots; ++i) {
+        if(set->slots[i] != 0) {
+            insert_slot(slots, n_slots, set->slots[i]);
+        }
+    }
+    free(set->slots);
+    set->slots = slots;
+    set->n_slots = n_slots;
+}
+
+static int compare_fingerprints(void const* a, void const* b) {
+    uint64_t fingerprint_a = *(uint64_t const*)a;
+    uint64_t fingerprint_b = *(uint64_t const*)b;
+    return (fingerprint_a > fingerprint_b) - (fingerprint_a < fingerprint_b);
+}
+
+// Merges the sorted table into a copy of the file, which then replaces it
+// The table holds no fingerprint of the file, see dedup_insert
+static bool flush_table(dedup_set* set) {
+    size_t n_used = 0;
+    for(size_t i = 0; i < set->n_slots; ++i) {
+        if(set->slots[i] != 0) {
+            set->slots[n_used++] = set->slots[i];
+        }
+    }
+    qsort(set->slots, n_used, sizeof(uint64_t), compare_fingerprints);
+
+    file_replace file;
+    if(!file_replace_open(&file, set->path, "wb")) {
+        perror("fingerprint set open failed");
+        return false;
+    }
+    FILE* file_ptr = file.file_ptr;
+    setvbuf(file_ptr, NULL, _IOFBF, DEDUP_WRITE_BUFFER_SIZE);
+
+    uint8_t version = DEDUP_VERSION;
+    uint64_t n_total = set->n_sorted + n_used;
+    bool is_ok = fwrite(DEDUP_MAGIC, sizeof(DEDUP_MAGIC), 1, file_ptr) == 1 &&
+                 fwrite(&version, sizeof(version), 1, file_ptr) == 1 &&
+                 fwrite(&n_total, sizeof(n_total), 1, file_ptr) == 1;
+
+    size_t i = 0;
+    size_t j = 0;
+    while(is_ok && (i < set->n_sorted || j < n_used)) {
+        uint64_t fingerprint;
+        if(j == n_used ||
+           (i < set->n_sorted && set->sorted[i] < set->slots[j])) {
+            fingerprint = set->sorted[i++];
+        } else {
+            fingerprint = set->slots[j++];
+        }
+        is_ok = fwrite(&fingerprint, sizeof(fingerprint), 1, file_ptr) == 1;
+    }
+
+    // the merged file replaces the mapped one, which is mapped again below
+    unmap_file(set);
+    if(!file_replace_commit(&file, is_ok)) {
+        perror("fingerprint set write failed");
+        is_ok = false;
+    }
+
+    // the old file is still in place if the write failed, the table is
+    // rebuilt and grows instead
+    is_ok = map_file(set) && is_ok;
+    uint64_t* kept = NULL;
+    if(!is_ok) {
+        kept = malloc(n_used * sizeof(uint64_t) + 1);
+        if(!kept) {
+            perror("malloc failed");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(kept, set->slots, n_used * sizeof(uint64_t));
+    }
+    memset(set->slots, 0, set->n_slots * sizeof(uint64_t));
+    if(kept) {
+        for(size_t k = 0; k < n_used; ++k) {
+            insert_slot(set->slots, set->n_slots, kept[k]);
+        }
+        free(kept);
+        return false;
+    }
+
+    set->n_used = 0;
+    ++set->n_flushes;
+    return true;
+}
+
+bool dedup_open(dedup_set* set, char const* path, size_t size_mb) {
+    memset(set, 0, sizeof(dedup_set));
+    size_t max_slots = (size_mb << 20) / sizeof(uint64_t);
+    size_t n_slots = 2;
+    while(n_slots * 2 <= max_slots) {
+        n_slots *= 2;
+    }
+
+    set->slots = calloc(n_slots, sizeof(uint64_t));
+    if(!set->slots) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    set->n_slots = n_slots;
+
+    set->path = path;
+    if(path && !map_file(set)) {
+        free(set->slots);
+        set->slots = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool dedup_insert(dedup_set* set, uint64_t fingerprint) {
+    if(fingerprint == 0) {
+        fingerprint = 1;
+    }
+
+    size_t i = fingerprint & (set->n_slots - 1);
+    while(set->slots[i] != 0) {
+        if(set->slots[i] == fingerprint) {
+            ++set->n_duplicates;
+            return false;
+        }
+        i = (i + 1) & (set->n_slots - 1);
+    }
+    if(set->sorted && is_in_file(set, fingerprint)) {
+        ++set->n_duplicates;
+        return false;
+    }
+
+    set->slots[i] = fingerprint;
+    ++set->n_used;
+    ++set->n_inserted;
+    if(set->n_used * 4 >= set->n_slots * 3) {
+        if(!set->path || !flush_table(set)) {
+            grow_table(set);
+        }
+    }
+    return true;
+}
+
+size_t dedup_size(dedup_set* set) {
+    return set->n_used + set->n_sorted;
+}
+
+bool dedup_close(dedup_set* set) {
+    bool is_ok = true;
+    if(set->path && (set->n_used > 0 || !set->data)) {
+        is_ok = flush_table(set);
+    }
+    unmap_file(set);
+    free(set->slots);
+    set->slots = NULL;
+    return is_ok;
+}
+
+void dedup_canonical_placements(puzzle_def* puzzle,
+                                int transform,
+                                node_placement* placements) {
+    // rows of every column that are covered by the placements so far, the
+    // skyline of the first empty cell search
+    int heights[DEDUP_MAX_GRID_DIMENSION] = {0};
+    assert(puzzle->grid_dimension <= DEDUP_MAX_GRID_DIMENSION);
+
+    int n_placements = 0;
+    for(int y_pos = 0; y_pos < puzzle->grid_dimension; ++y_pos) {
+        int x_pos = 0;
+        while(x_pos < puzzle->grid_dimension) {
+            if(heights[x_pos] > y_pos) {
+                ++x_pos;
+                continue;
+            }
+
+            int tile = get_transformed_tile(puzzle, transform, x_pos, y_pos);
+            node_placement* placement = &placements[n_placements++];
+            placement->tile_type = (uint8_t)tile;
+            placement->x_pos = (uint8_t)x_pos;
+            placement->y_pos = (uint8_t)y_pos;
+            placement->valid_tiles = 0;
+            for(int i = 0; i < tile; ++i) {
+                heights[x_pos + i] = y_pos + tile;
+            }
+            x_pos += tile;
+        }
+    }
+}
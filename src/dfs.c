@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dfs.h>
+
+void dfs_init(search_state* state, puzzle_def* puzzle, SEARCH_MODE mode) {
+    state->puzzle = puzzle;
+    state->mode = mode;
+
+    state->max_depth = dfs_max_depth(puzzle->size);
+    state->path = calloc((size_t)state->max_depth + 1, sizeof(node_placement));
+    state->level_solutions =
+        calloc((size_t)state->max_depth + 1, sizeof(uint64_t));
+    if(!state->path || !state->level_solutions) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    state->depth = 0;
+
+    state->n_nodes = 0;
+    state->n_backtracks = 0;
+    state->deepest_depth = 0;
+    state->n_solutions = 0;
+    state->n_unique_solutions = 0;
+    state->n_raw_solutions = 0;
+    state->break_symmetry = false;
+
+    state->prune_rules = DEFAULT_PRUNE_RULES;
+    memset(state->n_prunes, 0, sizeof(state->n_prunes));
+
+    state->select_func = NULL;
+    state->select_ctx = NULL;
+    state->node_limit = 0;
+
+    state->tt = NULL;
+    state->n_tt_hits = 0;
+    state->n_tt_misses = 0;
+}
+
+void dfs_unwind(search_state* state, int depth) {
+    for(int i = state->depth; i >= depth; --i) {
+        node_placement* level = &state->path[i];
+        if(level->tile_type != 0) {
+            remove_block(state->puzzle, level->tile_type, level->x_pos,
+                         level->y_pos);
+            level->tile_type = 0;
+        }
+    }
+    state->depth = depth;
+}
+
+void dfs_free(search_state* state) {
+    free(state->path);
+    state->path = NULL;
+    free(state->level_solutions);
+    state->level_solutions = NULL;
+    state->depth = 0;
+}
+
+// One piece of size 1, two of size 2, ... -> the triangular number
+int dfs_max_depth(int puzzle_type) {
+    return (puzzle_type * (puzzle_type + 1)) / 2;
+}
+
+void dfs_record_solution(search_state* state) {
+    bool is_unique;
+    int n_copies;
+    classify_solution(state->puzzle, state->break_symmetry, &is_unique,
+                      &n_copies);
+
+    ++state->n_solutions;
+    if(is_unique) {
+        ++state->n_unique_solutions;
+        state->n_raw_solutions += n_copies;
+    }
+
+    if(state->solution_func)
+        state->solution_func(state, state->solution_ctx);
+}
+
+uint16_t dfs_available_tiles(puzzle_def* puzzle) {
+    uint16_t valid_tiles = 0;
+    for(int i = 1; i <= puzzle->size; ++i) {
+        if(get_n_available_pieces(puzzle, i) > 0) {
+            valid_tiles |= 1 << (i - 1);
+        }
+    }
+    return valid_tiles;
+}
+
+// Opens a new level on the path at the first empty cell
+// Returns false if the board has no empty cell left
+static bool dfs_open_level(search_state* state) {
+    point cell = {0};
+    if(!line_scan_hor(state->puzzle, &cell)) {
+        return false;
+    }
+
+    node_placement* level = &state->path[state->depth];
+    level->tile_type = 0;
+    level->x_pos = cell.x_index;
+    level->y_pos = cell.y_index;
+    level->valid_tiles =
+        dfs_available_tiles(state->puzzle) &
+        FIT_TILES(get_max_fit(state->puzzle, cell.x_index, cell.y_index));
+    state->level_solutions[state->depth] = state->n_solutions;
+
+    return true;
+}
+
+// Iterative DFS over the tilings reachable from the current board
+// - SEARCH_FIRST: stops on the first solution, board is left solved
+// - SEARCH_COUNT: exhausts the search space, board is left as it was
+// Returns true if at least one solution was found
+bool dfs_run(search_state* state) {
+    puzzle_def* puzzle = state->puzzle;
+
+    if(is_puzzle_solved(puzzle)) {
+        dfs_record_solution(state);
+        return true;
+    }
+
+    int base_depth = state->depth;
+    dfs_open_level(state);
+    return dfs_resume(state, base_depth);
+}
+
+bool dfs_resume(search_state* state, int base_depth) {
+    puzzle_def* puzzle = state->puzzle;
+    while(state->depth >= base_depth) {
+        if(state->cancel && atomic_load_explicit(state->cancel,
+                                                 memory_order_relaxed)) {
+            return state->n_solutions > 0;
+        }
+        if(state->node_limit && state->n_nodes >= state->node_limit) {
+            return state->n_solutions > 0;
+        }
+
+        node_placement* level = &state->path[state->depth];
+
+        // undo the placement of the previous attempt at this level
+        if(level->tile_type != 0) {
+            remove_block(puzzle, level->tile_type, level->x_pos,
+                         level->y_pos);
+            level->tile_type = 0;
+            ++state->n_backtracks;
+        }
+
+        if(level->valid_tiles == 0) {
+            if(state->tt &&
+               state->level_solutions[state->depth] == state->n_solutions) {
+                tt_store(state->tt,
+                         tt_state_key(puzzle, state->break_symmetry),
+                         tt_remaining_pieces(puzzle));
+            }
+            --state->depth;
+            continue;
+        }
+
+        int selected_tile =
+            state->select_func
+                ? state->select_func(puzzle, level->valid_tiles,
+                                     state->select_ctx)
+                : __builtin_ctz(level->valid_tiles) + 1;
+        level->valid_tiles &= ~(1 << (selected_tile - 1));
+
+        if(state->break_symmetry &&
+           !is_symmetry_allowed(puzzle, selected_tile, level->x_pos,
+                                level->y_pos)) {
+            continue;
+        }
+        if(place_block(puzzle, selected_tile, level->x_pos, level->y_pos) !=
+           SUCCESS) {
+            continue;
+        }
+        level->tile_type = selected_tile;
+
+        if(++state->n_nodes % DFS_PROGRESS_INTERVAL == 0 &&
+           state->progress_func) {
+            state->progress_func(state, state->progress_ctx);
+        }
+
+        if(is_puzzle_solved(puzzle)) {
+            dfs_record_solution(state);
+
+            if(state->mode == SEARCH_FIRST) {
+                return true;
+            }
+            continue;
+        }
+
+        PRUNE_RULE prune_rule = check_prune_rules(puzzle, state->prune_rules);
+        if(prune_rule != NO_PRUNE) {
+            ++state->n_prunes[prune_rule];
+            continue;
+        }
+
+        if(state->tt) {
+            if(tt_probe(state->tt,
+                        tt_state_key(puzzle, state->break_symmetry))) {
+                ++state->n_tt_hits;
+                continue;
+            }
+            ++state->n_tt_misses;
+        }
+
+        ++state->depth;
+        state->deepest_depth = state->depth > state->deepest_depth
+                                   ? state->depth
+                                   : state->deepest_depth;
+        dfs_open_level(state);
+    }
+    state->depth = base_depth;
+
+    return state->n_solutions > 0;
+}
@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dlx.h>
+
+// Node 0 is the root, nodes 1..n_cells the cell columns and the next
+// puzzle->size nodes the piece columns, the rows follow.
+// Only the free cell columns are linked into the root list, the piece
+// columns are linked to themselves and never chosen for branching.
+typedef struct {
+    int n_cells;
+    int n_headers;
+    int n_nodes;
+
+    int* left;
+    int* right;
+    int* up;
+    int* down;
+    int* column;
+    int* row;
+    // per header
+    int* column_size;
+    // per piece size, the pieces that can still be placed
+    int* remaining;
+
+    node_placement* rows;
+    int n_rows;
+
+    // per depth the covered column and the row tried in it,
+    // level_row == level_column before the first row is tried
+    int* level_column;
+    int* level_row;
+} dlx_matrix;
+
+static void* dlx_calloc(size_t n, size_t size) {
+    void* ptr = calloc(n, size);
+    if(!ptr) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+static bool is_piece_column(dlx_matrix* matrix, int column) {
+    return column > matrix->n_cells;
+}
+
+static int cell_column(puzzle_def* puzzle, int x_pos, int y_pos) {
+    return y_pos * puzzle->grid_dimension + x_pos + 1;
+}
+
+static void append_row(dlx_matrix* matrix,
+                       puzzle_def* puzzle,
+                       int block_id,
+                       int x_pos,
+                       int y_pos) {
+    int row_id = matrix->n_rows++;
+    node_placement* placement = &matrix->rows[row_id];
+    placement->tile_type = block_id;
+    placement->x_pos = x_pos;
+    placement->y_pos = y_pos;
+    placement->valid_tiles = 0;
+
+    int first = matrix->n_nodes;
+    int n_row_nodes = block_id * block_id + 1;
+    for(int i = 0; i < n_row_nodes; ++i) {
+        int node = first + i;
+        int column;
+        if(i == 0) {
+            column = matrix->n_cells + block_id;
+        } else {
+            int cell = i - 1;
+            column = cell_column(puzzle, x_pos + cell % block_id,
+                                 y_pos + cell / block_id);
+        }
+
+        matrix->column[node] = column;
+        matrix->row[node] = row_id;
+        matrix->left[node] = i == 0 ? first + n_row_nodes - 1 : node - 1;
+        matrix->right[node] = i == n_row_nodes - 1 ? first : node + 1;
+
+        // append at the bottom of the column
+        matrix->up[node] = matrix->up[column];
+        matrix->down[node] = column;
+        matrix->down[matrix->up[column]] = node;
+        matrix->up[column] = node;
+        ++matrix->column_size[column];
+    }
+    matrix->n_nodes += n_row_nodes;
+}
+
+// Builds the matrix for the free cells of the board and the pieces that
+// are still available
+static void dlx_build(dlx_matrix* matrix, puzzle_def* puzzle, int max_depth) {
+    int grid_size = puzzle->grid_dimension;
+    matrix->n_cells = grid_size * grid_size;
+    matrix->n_headers = matrix->n_cells + puzzle->size + 1;
+
+    // a first pass counts the rows and nodes
+    int n_rows = 0;
+    size_t n_nodes = (size_t)matrix->n_headers;
+    for(int block_id = 1; block_id <= puzzle->size; ++block_id) {
+        if(get_n_available_pieces(puzzle, block_id) <= 0) {
+            continue;
+        }
+        for(int y = 0; y + block_id <= grid_size; ++y) {
+            for(int x = 0; x + block_id <= grid_size; ++x) {
+                if(placement_resolvable(puzzle, block_id, x, y)) {
+                    ++n_rows;
+                    n_nodes += (size_t)(block_id * block_id + 1);
+                }
+            }
+        }
+    }
+
+    matrix->left = dlx_calloc(n_nodes, sizeof(int));
+    matrix->right = dlx_calloc(n_nodes, sizeof(int));
+    matrix->up = dlx_calloc(n_nodes, sizeof(int));
+    matrix->down = dlx_calloc(n_nodes, sizeof(int));
+    matrix->column = dlx_calloc(n_nodes, sizeof(int));
+    matrix->row = dlx_calloc(n_nodes, sizeof(int));
+    matrix->column_size = dlx_calloc((size_t)matrix->n_headers, sizeof(int));
+    matrix->remaining = dlx_calloc((size_t)puzzle->size + 1, sizeof(int));
+    matrix->rows = dlx_calloc((size_t)n_rows + 1, sizeof(node_placement));
+    matrix->level_column = dlx_calloc((size_t)max_depth + 1, sizeof(int));
+    matrix->level_row = dlx_calloc((size_t)max_depth + 1, sizeof(int));
+
+    for(int node = 0; node < matrix->n_headers; ++node) {
+        matrix->left[node] = node;
+        matrix->right[node] = node;
+        matrix->up[node] = node;
+        matrix->down[node] = node;
+        matrix->column[node] = node;
+    }
+
+    // link the free cells in row-major order, so ties in the column
+    // choice go to the first empty cell
+    int last = 0;
+    for(int y = 0; y < grid_size; ++y) {
+        for(int x = 0; x < grid_size; ++x) {
+            if(is_cell_occupied(puzzle, x, y)) {
+                continue;
+            }
+            int column = cell_column(puzzle, x, y);
+            matrix->left[column] = last;
+            matrix->right[last] = column;
+            last = column;
+        }
+    }
+    matrix->left[0] = last;
+    matrix->right[last] = 0;
+
+    matrix->n_nodes = matrix->n_headers;
+    for(int block_id = 1; block_id <= puzzle->size; ++block_id) {
+        matrix->remaining[block_id] = get_n_available_pieces(puzzle, block_id);
+        if(matrix->remaining[block_id] <= 0) {
+            continue;
+        }
+        for(int y = 0; y + block_id <= grid_size; ++y) {
+            for(int x = 0; x + block_id <= grid_size; ++x) {
+                if(placement_resolvable(puzzle, block_id, x, y)) {
+                    append_row(matrix, puzzle, block_id, x, y);
+                }
+            }
+        }
+    }
+}
+
+static void dlx_free(dlx_matrix* matrix) {
+    free(matrix->left);
+    free(matrix->right);
+    free(matrix->up);
+    free(matrix->down);
+    free(matrix->column);
+    free(matrix->row);
+    free(matrix->column_size);
+    free(matrix->remaining);
+    free(matrix->rows);
+    free(matrix->level_column);
+    free(matrix->level_row);
+}
+
+static void cover(dlx_matrix* matrix, int column) {
+    int* left = matrix->left;
+    int* right = matrix->right;
+    int* up = matrix->up;
+    int* down = matrix->down;
+
+    right[left[column]] = right[column];
+    left[right[column]] = left[column];
+    for(int i = down[column]; i != column; i = down[i]) {
+        for(int j = right[i]; j != i; j = right[j]) {
+            down[up[j]] = down[j];
+            up[down[j]] = up[j];
+            --matrix->column_size[matrix->column[j]];
+        }
+    }
+}
+
+static void uncover(dlx_matrix* matrix, int column) {
+    int* left = matrix->left;
+    int* right = matrix->right;
+    int* up = matrix->up;
+    int* down = matrix->down;
+
+    for(int i = up[column]; i != column; i = up[i]) {
+        for(int j = left[i]; j != i; j = left[j]) {
+            ++matrix->column_size[matrix->column[j]];
+            down[up[j]] = j;
+            up[down[j]] = j;
+        }
+    }
+    right[left[column]] = column;
+    left[right[column]] = column;
+}
+
+// Covers the other columns of row_node, a piece column is only covered
+// once its last piece is used
+static void select_row(dlx_matrix* matrix, int row_node) {
+    for(int j = matrix->right[row_node]; j != row_node; j = matrix->right[j]) {
+        int column = matrix->column[j];
+        if(!is_piece_column(matrix, column)) {
+            cover(matrix, column);
+        } else if(--matrix->remaining[column - matrix->n_cells] == 0) {
+            cover(matrix, column);
+        }
+    }
+}
+
+static void deselect_row(dlx_matrix* matrix, int row_node) {
+    for(int j = matrix->left[row_node]; j != row_node; j = matrix->left[j]) {
+        int column = matrix->column[j];
+        if(!is_piece_column(matrix, column)) {
+            uncover(matrix, column);
+        } else if(matrix->remaining[column - matrix->n_cells]++ == 0) {
+            uncover(matrix, column);
+        }
+    }
+}
+
+// The cell column with the fewest rows, an empty one ends the branch
+static int choose_column(dlx_matrix* matrix) {
+    int best = matrix->right[0];
+    for(int c = matrix->right[best]; c != 0 && matrix->column_size[best] > 1;
+        c = matrix->right[c]) {
+        if(matrix->column_size[c] < matrix->column_size[best]) {
+            best = c;
+        }
+    }
+    return best;
+}
+
+static void open_level(dlx_matrix* matrix, int depth) {
+    int column = choose_column(matrix);
+    cover(matrix, column);
+    matrix->level_column[depth] = column;
+    matrix->level_row[depth] = column;
+}
+
+bool dlx_run(search_state* state) {
+    puzzle_def* puzzle = state->puzzle;
+    state->break_symmetry = false;
+
+    if(is_puzzle_solved(puzzle)) {
+        dfs_record_solution(state);
+        return true;
+    }
+
+    dlx_matrix matrix = {0};
+    dlx_build(&matrix, puzzle, state->max_depth);
+
+    int base_depth = state->depth;
+    open_level(&matrix, state->depth);
+
+    bool is_done = false;
+    while(state->depth >= base_depth) {
+        if(state->cancel && atomic_load_explicit(state->cancel,
+                                                 memory_order_relaxed)) {
+            is_done = true;
+            break;
+        }
+        if(state->node_limit && state->n_nodes >= state->node_limit) {
+            is_done = true;
+            break;
+        }
+
+        int depth = state->depth;
+        int column = matrix.level_column[depth];
+        int row_node = matrix.level_row[depth];
+        node_placement* level = &state->path[depth];
+
+        // undo the previous attempt at this level
+        if(row_node != column) {
+            deselect_row(&matrix, row_node);
+            remove_block(puzzle, level->tile_type, level->x_pos,
+                         level->y_pos);
+            ++state->n_backtracks;
+        }
+
+        row_node = matrix.down[row_node];
+        matrix.level_row[depth] = row_node;
+        if(row_node == column) {
+            uncover(&matrix, column);
+            --state->depth;
+            continue;
+        }
+
+        select_row(&matrix, row_node);
+        *level = matrix.rows[matrix.row[row_node]];
+        place_block(puzzle, level->tile_type, level->x_pos, level->y_pos);
+
+        if(++state->n_nodes % DFS_PROGRESS_INTERVAL == 0 &&
+           state->progress_func) {
+            state->progress_func(state, state->progress_ctx);
+        }
+
+        if(matrix.right[0] == 0) {
+            dfs_record_solution(state);
+
+            if(state->mode == SEARCH_FIRST) {
+                is_done = true;
+                break;
+            }
+            continue;
+        }
+
+        // the board is kept in sync with the matrix, so the prune rules of
+        // the placement search apply
+        PRUNE_RULE prune_rule = check_prune_rules(puzzle, state->prune_rules);
+        if(prune_rule != NO_PRUNE) {
+            ++state->n_prunes[prune_rule];
+            continue;
+        }
+
+        ++state->depth;
+        state->deepest_depth = state->depth > state->deepest_depth
+                                   ? state->depth
+                                   : state->deepest_depth;
+        open_level(&matrix, state->depth);
+    }
+    if(!is_done) {
+        state->depth = base_depth;
+    }
+
+    dlx_free(&matrix);
+    return state->n_solutions > 0;
+}
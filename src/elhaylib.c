@@ -364,10 +364,88 @@ void stack_free(stack_head* stack) {
     free(stack);
 }
 
+// ARENA
+struct arena_chunk {
+    arena_chunk* prev_chunk;
+    size_t chunk_capacity;
+    char data[];
+};
+
+void arena_init(arena_head* const ptr_head, size_t chunk_size) {
+    ptr_head->chunk_size =
+        chunk_size > 0 ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+    ptr_head->chunk_used = 0;
+    ptr_head->n_chunks = 0;
+    ptr_head->bytes_allocated = 0;
+    ptr_head->ptr_chunk = NULL;
+}
+
+void* arena_alloc(arena_head* const ptr_head, size_t size) {
+    // keep every allocation aligned for pointers and 64 bit integers
+    size = (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+
+    arena_chunk* chunk = ptr_head->ptr_chunk;
+    if(!chunk || ptr_head->chunk_used + size > chunk->chunk_capacity) {
+        size_t capacity =
+            size > ptr_head->chunk_size ? size : ptr_head->chunk_size;
+        chunk = malloc(sizeof(arena_chunk) + capacity);
+        if(!chunk) {
+            perror("malloc failed");
+            exit(EXIT_FAILURE);
+        }
+
+        chunk->prev_chunk = ptr_head->ptr_chunk;
+        chunk->chunk_capacity = capacity;
+        ptr_head->ptr_chunk = chunk;
+        ptr_head->chunk_used = 0;
+        ++ptr_head->n_chunks;
+    }
+
+    void* ptr = chunk->data + ptr_head->chunk_used;
+    ptr_head->chunk_used += size;
+    ptr_head->bytes_allocated += size;
+    memset(ptr, 0, size);
+
+    return ptr;
+}
+
+void arena_reset(arena_head* const ptr_head) {
+    arena_chunk* chunk = ptr_head->ptr_chunk;
+    if(!chunk) {
+        return;
+    }
+
+    arena_chunk* prev_chunk = chunk->prev_chunk;
+    while(prev_chunk) {
+        arena_chunk* next_prev = prev_chunk->prev_chunk;
+        free(prev_chunk);
+        prev_chunk = next_prev;
+    }
+
+    chunk->prev_chunk = NULL;
+    ptr_head->chunk_used = 0;
+    ptr_head->n_chunks = 1;
+    ptr_head->bytes_allocated = 0;
+}
+
+void arena_free(arena_head* const ptr_head) {
+    arena_reset(ptr_head);
+    free(ptr_head->ptr_chunk);
+    ptr_head->ptr_chunk = NULL;
+    ptr_head->n_chunks = 0;
+}
+
 // TREE
 void tree_init(tree_head* const ptr_head) {
     ptr_head->tree_size = 0;
     ptr_head->tree_root = NULL;
+    ptr_head->arena = NULL;
+    ptr_head->free_nodes = NULL;
+}
+
+void tree_init_arena(tree_head* const ptr_head, arena_head* const arena) {
+    tree_init(ptr_head);
+    ptr_head->arena = arena;
 }
 
 void tree_node_root(tree_op_res* op_res,
@@ -375,7 +453,8 @@ void tree_node_root(tree_op_res* op_res,
                     node_type dtype,
                     size_t data_size,
                     void const* data) {
-    tree_node* new_node_ptr = tree_prepare_node(dtype, data_size, data);
+    tree_node* new_node_ptr =
+        tree_new_node(ptr_head, dtype, data_size, data);
     ptr_head->tree_root = new_node_ptr;
     ptr_head->tree_size++;
 
@@ -389,11 +468,9 @@ void tree_node_add(tree_op_res* op_res,
                    node_type dtype,
                    size_t data_size,
                    void const* data) {
-    tree_node* new_node_ptr = tree_prepare_node(dtype, data_size, data);
-    new_node_ptr->parent = ptr_parent;
-
-    dynarr_head* child_nodes_head = &ptr_parent->children;
-    dynarr_append(child_nodes_head, &new_node_ptr);
+    tree_node* new_node_ptr =
+        tree_new_node(ptr_head, dtype, data_size, data);
+    tree_link_child(ptr_parent, new_node_ptr, SIZE_MAX);
     ptr_head->tree_size++;
 
     op_res->code = OK;
@@ -407,11 +484,9 @@ void tree_node_add_at_index(tree_op_res* op_res,
                             node_type dtype,
                             size_t data_size,
                             void const* data) {
-    tree_node* new_node_ptr = tree_prepare_node(dtype, data_size, data);
-    new_node_ptr->parent = ptr_parent;
-
-    dynarr_head* child_nodes_head = &ptr_parent->children;
-    dynarr_insert(child_nodes_head, &new_node_ptr, graft_index);
+    tree_node* new_node_ptr =
+        tree_new_node(ptr_head, dtype, data_size, data);
+    tree_link_child(ptr_parent, new_node_ptr, graft_index);
     ptr_head->tree_size++;
 
     op_res->code = OK;
@@ -429,23 +504,8 @@ void tree_detach_subtree(tree_op_res* op_res,
         tree_detach_root(op_res, ptr_head);
         return;
     }
-    tree_node* ptr_parent = ptr_node->parent;
-
-    // find index of node in parent children array
-    size_t node_index = 0;
-    tree_node** test_node_ptr =
-        (tree_node**)ptr_parent->children.ptr_first_elem;
-
-    while(*test_node_ptr != ptr_node) {
-        assert(node_index < ptr_parent->children.dynarr_size &&
-               "Tree Corruption: Node not found in parent children array.");
-        ++node_index;
-        ++test_node_ptr;
-    }
 
-    // remove ptr from parent children array
-    dynarr_remove(&ptr_parent->children, node_index);
-    ptr_node->parent = NULL;
+    tree_unlink_child(ptr_node);
     size_t subtree_size = tree_count_nodes(ptr_node);
     ptr_head->tree_size -= subtree_size;
 
@@ -464,16 +524,11 @@ void tree_graft_subtree(tree_op_res* op_res,
                         tree_node* ptr_new_parent,
                         tree_node* ptr_node,
                         size_t graft_index) {
+    // only attached nodes have a parent
     if(ptr_node->parent != NULL) {
-        dynarr_head children_array = ptr_node->parent->children;
-        tree_node** test_node_ptr = (tree_node**)children_array.ptr_first_elem;
-        for(size_t i = 0; i < children_array.dynarr_size; ++i) {
-            if(*test_node_ptr == ptr_node) {
-                op_res->code = SUBTREE_ATTACHED;
-                op_res->node_ptr = NULL;
-                return;
-            }
-        }
+        op_res->code = SUBTREE_ATTACHED;
+        op_res->node_ptr = NULL;
+        return;
     }
 
     size_t subtree_size = tree_count_nodes(ptr_node);
@@ -481,9 +536,7 @@ void tree_graft_subtree(tree_op_res* op_res,
     if(ptr_new_parent == NULL) {
         ptr_head->tree_root = ptr_node;
     } else {
-        dynarr_head* child_nodes_head = &ptr_new_parent->children;
-        dynarr_insert(child_nodes_head, &ptr_node, graft_index);
-        ptr_node->parent = ptr_new_parent;
+        tree_link_child(ptr_new_parent, ptr_node, graft_index);
     }
     ptr_head->tree_size += subtree_size;
 
@@ -512,42 +565,112 @@ void tree_detach_graft_subtree(tree_op_res* op_res,
 }
 
 tree_node* tree_get_ith_node_ptr(tree_node* ptr_node, size_t i) {
-    tree_node** pointer_to_children_pointers =
-        (tree_node**)ptr_node->children.ptr_first_elem;
-    tree_node* child_node_ptr = *(pointer_to_children_pointers + i);
+    tree_node* child_node_ptr = ptr_node->first_child;
+    for(; i > 0; --i) {
+        assert(child_node_ptr && "Child index out of bounds.");
+        child_node_ptr = child_node_ptr->next_sibling;
+    }
 
     return child_node_ptr;
 }
 
+size_t tree_n_children(tree_node* ptr_node) {
+    size_t children_count = 0;
+    for(tree_node* child = ptr_node->first_child; child;
+        child = child->next_sibling) {
+        ++children_count;
+    }
+
+    return children_count;
+}
+
+// Pre-order walk along the child and sibling links, a node without a
+// next sibling climbs back up until one of its ancestors has one
 size_t tree_count_nodes(tree_node* ptr_node) {
-    size_t tree_count = 1;
-    size_t children_count = ptr_node->children.dynarr_size;
-    if(children_count == 0) {
-        return tree_count;
-    } else {
-        for(size_t i = 0; i < children_count; ++i) {
-            tree_node* current_child_ptr = tree_get_ith_node_ptr(ptr_node, i);
-            tree_count += tree_count_nodes(current_child_ptr++);
+    size_t tree_count = 0;
+    tree_node* current_node = ptr_node;
+    while(current_node) {
+        ++tree_count;
+        if(current_node->first_child) {
+            current_node = current_node->first_child;
+            continue;
+        }
+
+        while(current_node != ptr_node && !current_node->next_sibling) {
+            current_node = current_node->parent;
         }
+        current_node =
+            current_node == ptr_node ? NULL : current_node->next_sibling;
     }
 
     return tree_count;
 }
 
 // To prune a subtree and free its memory it is necessary to
-// visit every node and free:
-//  1. The node's linked list of pointers and then
-//  2. The node itself
+// visit every node and free it once its children are freed.
 // The nodes need to be visited in Post-order(LRN)
 //
 // Implementation approach:
-// 1. Create a stack of pointers to all to be freed nodes in Post-order(LRN)
-// 2. Pop the stack and free the node's list and then the node
-// void tree_prune(tree_head* const ptr_head, tree_node* ptr_node) {}
+// Instead of a stack or recursion the walk descends into the first child
+// and unlinks it from its parent. A node without children left is freed
+// and the walk climbs back to its parent, so no extra memory is needed no
+// matter how deep or wide the subtree is.
+void tree_prune(tree_op_res* op_res,
+                tree_head* const ptr_head,
+                tree_node* ptr_node) {
+    if(ptr_node == ptr_head->tree_root) {
+        tree_free(op_res, ptr_head);
+        return;
+    }
+
+    // detached subtrees are freed without touching the tree size
+    bool is_attached = ptr_node->parent != NULL;
+    if(is_attached) {
+        tree_unlink_child(ptr_node);
+    }
+
+    size_t n_freed = 0;
+    tree_node* current_node = ptr_node;
+    while(current_node) {
+        tree_node* child = current_node->first_child;
+        if(child) {
+            current_node->first_child = child->next_sibling;
+            current_node = child;
+            continue;
+        }
+
+        tree_node* parent = current_node == ptr_node ? NULL
+                                                     : current_node->parent;
+        tree_free_node(op_res, ptr_head, current_node);
+        ++n_freed;
+        current_node = parent;
+    }
+
+    if(is_attached) {
+        ptr_head->tree_size -= n_freed;
+    }
+
+    op_res->code = OK;
+    op_res->node_ptr = NULL;
+}
 
 // A tree free is a tree prune with the tree root as the prune
-// subtree root
-// void tree_free(tree_head* const ptr_head) {}
+// subtree root. The nodes of an arena tree are released in bulk.
+void tree_free(tree_op_res* op_res, tree_head* const ptr_head) {
+    tree_node* root = ptr_head->tree_root;
+    ptr_head->tree_root = NULL;
+
+    if(ptr_head->arena) {
+        arena_reset(ptr_head->arena);
+        ptr_head->free_nodes = NULL;
+    } else if(root) {
+        tree_prune(op_res, ptr_head, root);
+    }
+    ptr_head->tree_size = 0;
+
+    op_res->code = OK;
+    op_res->node_ptr = NULL;
+}
 
 // internals
 tree_node* tree_prepare_node(node_type dtype,
@@ -559,13 +682,103 @@ tree_node* tree_prepare_node(node_type dtype,
         exit(EXIT_FAILURE);
     }
 
-    new_node_ptr->data_size = data_size;
+    new_node_ptr->data_size = (uint32_t)data_size;
     new_node_ptr->dtype = dtype;
     memcpy(new_node_ptr->data, data, data_size);
 
-    new_node_ptr->children.dynarr_size = 2;
-    new_node_ptr->children.elem_size = sizeof(tree_node*);
-    dynarr_init(&new_node_ptr->children);
+    return new_node_ptr;
+}
+
+// Arena nodes are padded so the next node stays pointer aligned
+static size_t tree_arena_node_bytes(size_t data_size) {
+    size_t node_bytes = sizeof(tree_node) + data_size;
+    return (node_bytes + sizeof(tree_node*) - 1) & ~(sizeof(tree_node*) - 1);
+}
+
+static tree_node* tree_setup_arena_node(void* memory,
+                                        node_type dtype,
+                                        size_t data_size,
+                                        void const* data) {
+    tree_node* new_node_ptr = memory;
+    memset(new_node_ptr, 0, sizeof(tree_node));
+    new_node_ptr->data_size = (uint32_t)data_size;
+    new_node_ptr->dtype = dtype;
+    memcpy(new_node_ptr->data, data, data_size);
 
     return new_node_ptr;
 }
+
+tree_node* tree_prepare_arena_node(arena_head* const arena,
+                                   node_type dtype,
+                                   size_t data_size,
+                                   void const* data) {
+    void* memory = arena_alloc(arena, tree_arena_node_bytes(data_size));
+
+    return tree_setup_arena_node(memory, dtype, data_size, data);
+}
+
+tree_node* tree_new_node(tree_head* const ptr_head,
+                         node_type dtype,
+                         size_t data_size,
+                         void const* data) {
+    assert(data_size <= UINT32_MAX && "Node data must be below 4 GiB.");
+
+    tree_node* free_node = ptr_head->free_nodes;
+    if(free_node && free_node->data_size == data_size) {
+        ptr_head->free_nodes = free_node->parent;
+        return tree_setup_arena_node(free_node, dtype, data_size, data);
+    }
+
+    if(ptr_head->arena) {
+        return tree_prepare_arena_node(ptr_head->arena, dtype, data_size,
+                                       data);
+    }
+    return tree_prepare_node(dtype, data_size, data);
+}
+
+// Heap nodes are freed, arena nodes are kept on the free list of the tree
+// and handed out again by tree_new_node
+void tree_free_node(tree_op_res* op_res,
+                    tree_head* const ptr_head,
+                    tree_node* const ptr_node) {
+    if(ptr_head->arena) {
+        ptr_node->parent = ptr_head->free_nodes;
+        ptr_head->free_nodes = ptr_node;
+    } else {
+        free(ptr_node);
+    }
+
+    op_res->code = OK;
+    op_res->node_ptr = NULL;
+}
+
+// Inserts ptr_node as the child at index, SIZE_MAX appends it
+void tree_link_child(tree_node* const ptr_parent,
+                     tree_node* const ptr_node,
+                     size_t index) {
+    size_t i = 0;
+    tree_node** link = &ptr_parent->first_child;
+    for(; i < index && *link; ++i) {
+        link = &(*link)->next_sibling;
+    }
+    assert((index == SIZE_MAX || i == index) &&
+           "Inserts must be within the bounds of the children.");
+    (void)i;
+
+    ptr_node->next_sibling = *link;
+    ptr_node->parent = ptr_parent;
+    *link = ptr_node;
+}
+
+void tree_unlink_child(tree_node* const ptr_node) {
+    tree_node** link = &ptr_node->parent->first_child;
+    while(*link != ptr_node) {
+        assert(*link &&
+               "Tree Corruption: Node not found in parent children list.");
+        link = &(*link)->next_sibling;
+    }
+
+    *link = ptr_node->next_sibling;
+    ptr_node->next_sibling = NULL;
+    ptr_node->parent = NULL;
+}
@@ -0,0 +1,64 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <fileio.h>
+
+bool file_replace_open(file_replace* const file,
+                       char const* path,
+                       char const* mode) {
+    size_t path_len = strlen(path);
+    file->path = path;
+    file->tmp_path = malloc(path_len + 5);
+    if(!file->tmp_path) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(file->tmp_path, path, path_len);
+    memcpy(file->tmp_path + path_len, ".tmp", 5);
+
+    file->file_ptr = fopen(file->tmp_path, mode);
+    if(!file->file_ptr) {
+        free(file->tmp_path);
+        file->tmp_path = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool file_replace_commit(file_replace* const file, bool is_ok) {
+    // the data has to be on disk before the rename replaces the old file,
+    // otherwise a crash can leave an empty file behind
+    is_ok = is_ok && fflush(file->file_ptr) == 0;
+#ifdef _WIN32
+    is_ok = is_ok && _commit(_fileno(file->file_ptr)) == 0;
+#else
+    is_ok = is_ok && fsync(fileno(file->file_ptr)) == 0;
+#endif
+    is_ok = fclose(file->file_ptr) == 0 && is_ok;
+    file->file_ptr = NULL;
+
+#ifdef _WIN32
+    // rename does not replace an existing file on Windows
+    if(is_ok) {
+        remove(file->path);
+    }
+#endif
+    is_ok = is_ok && rename(file->tmp_path, file->path) == 0;
+    if(!is_ok) {
+        int error = errno;
+        remove(file->tmp_path);
+        errno = error;
+    }
+
+    free(file->tmp_path);
+    file->tmp_path = NULL;
+    return is_ok;
+}
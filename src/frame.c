@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <frame.h>
+
+static void sleep_frame(int fps) {
+#ifdef _WIN32
+    Sleep(1000 / fps);
+#else
+    long period_ns = 1000000000L / fps;
+    struct timespec period = {period_ns / 1000000000L,
+                              period_ns % 1000000000L};
+    nanosleep(&period, NULL);
+#endif
+}
+
+static void* frame_run(void* arg) {
+    frame_state* frames = (frame_state*)arg;
+
+    while(!atomic_load(&frames->is_stopped)) {
+        // a frame was published since the last request
+        if(!atomic_load_explicit(&frames->is_requested,
+                                 memory_order_acquire)) {
+            int front =
+                atomic_load_explicit(&frames->front, memory_order_acquire);
+            frame_buffer const* frame = &frames->buffers[front];
+
+            // the search fills the other buffer while this one is drawn
+            atomic_store_explicit(&frames->is_requested, true,
+                                  memory_order_release);
+            frames->draw_func(frame->placements, frame->n_placements,
+                              frames->draw_ctx);
+            ++frames->n_frames;
+        }
+        sleep_frame(frames->fps);
+    }
+    return NULL;
+}
+
+void frame_init(frame_state* frames,
+                int max_placements,
+                int fps,
+                FRAME_DRAW_F_PTR draw_func,
+                void* draw_ctx) {
+    memset(frames, 0, sizeof(frame_state));
+    for(int i = 0; i < 2; ++i) {
+        frames->buffers[i].placements =
+            calloc((size_t)max_placements, sizeof(node_placement));
+        if(!frames->buffers[i].placements) {
+            perror("calloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    frames->max_placements = max_placements;
+    atomic_init(&frames->front, 0);
+    atomic_init(&frames->is_requested, true);
+    atomic_init(&frames->is_stopped, false);
+
+    frames->fps = fps > 0 ? fps : FRAME_DEFAULT_FPS;
+    frames->draw_func = draw_func;
+    frames->draw_ctx = draw_ctx;
+}
+
+bool frame_start(frame_state* frames) {
+    frames->is_running =
+        pthread_create(&frames->thread, NULL, frame_run, frames) == 0;
+    return frames->is_running;
+}
+
+void frame_stop(frame_state* frames) {
+    if(!frames->is_running) {
+        return;
+    }
+    atomic_store(&frames->is_stopped, true);
+    pthread_join(frames->thread, NULL);
+    frames->is_running = false;
+}
+
+void frame_free(frame_state* frames) {
+    frame_stop(frames);
+    for(int i = 0; i < 2; ++i) {
+        free(frames->buffers[i].placements);
+        frames->buffers[i].placements = NULL;
+    }
+}
+
+void frame_publish(frame_state* frames,
+                   node_placement const* placements,
+                   int n_placements) {
+    // pairs with the release of is_requested, frame_is_due only peeks at
+    // it. The render thread is done with the back buffer.
+    if(!atomic_load_explicit(&frames->is_requested, memory_order_acquire)) {
+        return;
+    }
+
+    int back =
+        1 - atomic_load_explicit(&frames->front, memory_order_relaxed);
+    frame_buffer* frame = &frames->buffers[back];
+    memcpy(frame->placements, placements,
+           (size_t)n_placements * sizeof(node_placement));
+    frame->n_placements = n_placements;
+
+    atomic_store_explicit(&frames->front, back, memory_order_release);
+    atomic_store_explicit(&frames->is_requested, false, memory_order_release);
+}
@@ -0,0 +1,447 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <elhaylib.h>
+#include <rng.h>
+
+// Microbenchmarks of the elhaylib containers
+// Every benchmark is run once as warm up and then repeats times per size,
+// the median and the best time per operation are reported. The binary is
+// linked with --wrap for the allocator functions, so every heap call made
+// inside the timed region is counted as well.
+#define LIB_BENCH_MAX_SIZES 16
+// dynarr_insert/dynarr_remove at the front are quadratic
+#define LIB_BENCH_QUADRATIC_CAP 100000
+#define LIB_BENCH_SEED 42
+
+typedef struct {
+    uint64_t n_malloc;
+    uint64_t n_calloc;
+    uint64_t n_realloc;
+    uint64_t n_free;
+} alloc_counts;
+
+static alloc_counts allocs;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    ++allocs.n_malloc;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    ++allocs.n_calloc;
+    return __real_calloc(n, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    ++allocs.n_realloc;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    ++allocs.n_free;
+    __real_free(ptr);
+}
+
+typedef struct {
+    double begin;
+    alloc_counts begin_allocs;
+
+    double seconds;
+    uint64_t n_ops;
+    uint64_t n_allocs;
+    uint64_t n_frees;
+} lib_sample;
+
+typedef void (*LIB_BENCH_F_PTR)(size_t, lib_sample*);
+
+typedef struct {
+    char const* name;
+    LIB_BENCH_F_PTR func;
+    bool is_quadratic;
+} lib_bench;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void sample_begin(lib_sample* sample) {
+    sample->begin_allocs = allocs;
+    sample->begin = now_seconds();
+}
+
+static void sample_end(lib_sample* sample, uint64_t n_ops) {
+    sample->seconds = now_seconds() - sample->begin;
+    sample->n_ops = n_ops;
+    sample->n_allocs = (allocs.n_malloc - sample->begin_allocs.n_malloc) +
+                       (allocs.n_calloc - sample->begin_allocs.n_calloc) +
+                       (allocs.n_realloc - sample->begin_allocs.n_realloc);
+    sample->n_frees = allocs.n_free - sample->begin_allocs.n_free;
+}
+
+// DYNAMIC ARRAY
+static void bench_dynarr_append(size_t n, lib_sample* sample) {
+    dynarr_head array = {0};
+    array.elem_size = sizeof(uint64_t);
+    dynarr_init(&array);
+
+    sample_begin(sample);
+    for(uint64_t i = 0; i < n; ++i) {
+        dynarr_append(&array, &i);
+    }
+    sample_end(sample, n);
+
+    dynarr_free(&array);
+}
+
+static void bench_dynarr_insert_front(size_t n, lib_sample* sample) {
+    dynarr_head array = {0};
+    array.elem_size = sizeof(uint64_t);
+    dynarr_init(&array);
+
+    sample_begin(sample);
+    for(uint64_t i = 0; i < n; ++i) {
+        dynarr_insert(&array, &i, 0);
+    }
+    sample_end(sample, n);
+
+    dynarr_free(&array);
+}
+
+static void bench_dynarr_remove_front(size_t n, lib_sample* sample) {
+    dynarr_head array = {0};
+    array.elem_size = sizeof(uint64_t);
+    array.dynarr_capacity = n;
+    dynarr_init(&array);
+    for(uint64_t i = 0; i < n; ++i) {
+        dynarr_append(&array, &i);
+    }
+
+    sample_begin(sample);
+    for(size_t i = 0; i < n; ++i) {
+        dynarr_remove(&array, 0);
+    }
+    sample_end(sample, n);
+
+    dynarr_free(&array);
+}
+
+static void bench_dynarr_remove_back(size_t n, lib_sample* sample) {
+    dynarr_head array = {0};
+    array.elem_size = sizeof(uint64_t);
+    array.dynarr_capacity = n;
+    dynarr_init(&array);
+    for(uint64_t i = 0; i < n; ++i) {
+        dynarr_append(&array, &i);
+    }
+
+    sample_begin(sample);
+    for(size_t i = n; i > 0; --i) {
+        dynarr_remove(&array, i - 1);
+    }
+    sample_end(sample, n);
+
+    dynarr_free(&array);
+}
+
+// LINKED LIST
+static void bench_linlst_append(size_t n, lib_sample* sample) {
+    linked_list_head list = {0};
+    linlst_init(&list);
+
+    sample_begin(sample);
+    for(uint64_t i = 0; i < n; ++i) {
+        linlst_append_node(&list, NODE_UINT64, sizeof(uint64_t), &i);
+    }
+    sample_end(sample, n);
+
+    linlst_delete_list(&list);
+    free(list.ptr_sentinel_node);
+}
+
+static void bench_linlst_delete_list(size_t n, lib_sample* sample) {
+    linked_list_head list = {0};
+    linlst_init(&list);
+    for(uint64_t i = 0; i < n; ++i) {
+        linlst_append_node(&list, NODE_UINT64, sizeof(uint64_t), &i);
+    }
+
+    sample_begin(sample);
+    linlst_delete_list(&list);
+    sample_end(sample, n);
+
+    free(list.ptr_sentinel_node);
+}
+
+// STACK
+static void bench_stack_push_pop(size_t n, lib_sample* sample) {
+    stack_head* stack = stack_init(sizeof(uint64_t));
+
+    sample_begin(sample);
+    for(uint64_t i = 0; i < n; ++i) {
+        stack_push(stack, &i);
+    }
+    uint64_t out = 0;
+    while(stack_pop(stack, &out)) {
+    }
+    sample_end(sample, 2 * n);
+
+    stack_free(stack);
+}
+
+// TREE
+// The trees are built by attaching every node to a random earlier node,
+// which keeps them shallow like the search trees of the solver.
+// With an arena the nodes are taken from it instead of the heap
+static tree_node** build_random_tree(tree_head* tree,
+                                     arena_head* arena,
+                                     size_t n) {
+    tree_node** nodes = calloc(n, sizeof(tree_node*));
+    if(!nodes) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    rng_state rng;
+    rng_seed(&rng, LIB_BENCH_SEED);
+
+    tree_op_res result;
+    uint64_t data = 0;
+    tree_init_arena(tree, arena);
+    tree_node_root(&result, tree, NODE_UINT64, sizeof(data), &data);
+    nodes[0] = result.node_ptr;
+    for(size_t i = 1; i < n; ++i) {
+        data = i;
+        tree_node* parent = nodes[rng_next(&rng) % i];
+        tree_node_add(&result, tree, parent, NODE_UINT64, sizeof(data),
+                      &data);
+        nodes[i] = result.node_ptr;
+    }
+
+    return nodes;
+}
+
+static void free_random_tree(tree_head* tree, tree_node** nodes) {
+    tree_op_res result;
+    tree_free(&result, tree);
+    free(nodes);
+}
+
+static void bench_tree_node_add(size_t n, lib_sample* sample) {
+    tree_head tree;
+    sample_begin(sample);
+    tree_node** nodes = build_random_tree(&tree, NULL, n);
+    sample_end(sample, n);
+
+    free_random_tree(&tree, nodes);
+}
+
+static void bench_tree_node_add_arena(size_t n, lib_sample* sample) {
+    tree_head tree;
+    arena_head arena;
+    arena_init(&arena, 0);
+
+    sample_begin(sample);
+    tree_node** nodes = build_random_tree(&tree, &arena, n);
+    sample_end(sample, n);
+
+    free_random_tree(&tree, nodes);
+    arena_free(&arena);
+}
+
+static bool is_ancestor(tree_node* ancestor, tree_node* node) {
+    for(; node; node = node->parent) {
+        if(node == ancestor) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Moves n random subtrees below random nodes outside of them and back, so
+// the shape of the tree and the cost of the moves stay the same
+static void bench_tree_detach_graft(size_t n, lib_sample* sample) {
+    tree_head tree;
+    tree_node** nodes = build_random_tree(&tree, NULL, n);
+
+    rng_state rng;
+    rng_seed(&rng, LIB_BENCH_SEED + 1);
+    size_t n_moves = n > 2 ? n : 0;
+
+    tree_op_res result;
+    sample_begin(sample);
+    for(size_t i = 0; i < n_moves; ++i) {
+        tree_node* node;
+        tree_node* new_parent;
+        do {
+            node = nodes[1 + rng_next(&rng) % (n - 1)];
+            new_parent = nodes[rng_next(&rng) % n];
+        } while(new_parent == node->parent ||
+                is_ancestor(node, new_parent));
+
+        tree_node* old_parent = node->parent;
+        tree_detach_graft_subtree(&result, &tree, &tree, new_parent, node,
+                                  0);
+        tree_detach_graft_subtree(&result, &tree, &tree, old_parent, node,
+                                  0);
+    }
+    sample_end(sample, 2 * n_moves);
+
+    free_random_tree(&tree, nodes);
+}
+
+static void bench_tree_count_nodes(size_t n, lib_sample* sample) {
+    tree_head tree;
+    tree_node** nodes = build_random_tree(&tree, NULL, n);
+
+    sample_begin(sample);
+    size_t n_counted = tree_count_nodes(tree.tree_root);
+    sample_end(sample, n_counted);
+
+    free_random_tree(&tree, nodes);
+}
+
+static void bench_tree_free(size_t n, lib_sample* sample) {
+    tree_head tree;
+    tree_node** nodes = build_random_tree(&tree, NULL, n);
+
+    tree_op_res result;
+    sample_begin(sample);
+    tree_free(&result, &tree);
+    sample_end(sample, n);
+
+    free(nodes);
+}
+
+static lib_bench const benches[] = {
+    {"dynarr_append", bench_dynarr_append, false},
+    {"dynarr_insert_front", bench_dynarr_insert_front, true},
+    {"dynarr_remove_front", bench_dynarr_remove_front, true},
+    {"dynarr_remove_back", bench_dynarr_remove_back, false},
+    {"linlst_append", bench_linlst_append, false},
+    {"linlst_delete_list", bench_linlst_delete_list, false},
+    {"stack_push_pop", bench_stack_push_pop, false},
+    {"tree_node_add", bench_tree_node_add, false},
+    {"tree_node_add_arena", bench_tree_node_add_arena, false},
+    {"tree_detach_graft", bench_tree_detach_graft, false},
+    {"tree_count_nodes", bench_tree_count_nodes, false},
+    {"tree_free", bench_tree_free, false},
+};
+
+static int compare_doubles(void const* a, void const* b) {
+    double lhs = *(double const*)a;
+    double rhs = *(double const*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static void run_bench(lib_bench const* bench,
+                      size_t n,
+                      int repeats,
+                      bool is_csv) {
+    double* ns_per_op = calloc((size_t)repeats, sizeof(double));
+    if(!ns_per_op) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    lib_sample sample = {0};
+    bench->func(n, &sample);
+    for(int i = 0; i < repeats; ++i) {
+        bench->func(n, &sample);
+        ns_per_op[i] = sample.n_ops ? sample.seconds * 1e9 / sample.n_ops : 0;
+    }
+    qsort(ns_per_op, (size_t)repeats, sizeof(double), compare_doubles);
+
+    double median_ns = ns_per_op[repeats / 2];
+    double best_ns = ns_per_op[0];
+    double mops = median_ns > 0 ? 1e3 / median_ns : 0;
+    double allocs_per_op =
+        sample.n_ops ? (double)sample.n_allocs / sample.n_ops : 0;
+    double frees_per_op =
+        sample.n_ops ? (double)sample.n_frees / sample.n_ops : 0;
+
+    if(is_csv) {
+        printf("%s,%zu,%" PRIu64 ",%.2f,%.2f,%.2f,%.4f,%.4f\n", bench->name,
+               n, sample.n_ops, median_ns, best_ns, mops, allocs_per_op,
+               frees_per_op);
+    } else {
+        printf("%-20s %10zu %12" PRIu64 " %10.2f %10.2f %10.2f %10.4f %10.4f\n",
+               bench->name, n, sample.n_ops, median_ns, best_ns, mops,
+               allocs_per_op, frees_per_op);
+    }
+    fflush(stdout);
+    free(ns_per_op);
+}
+
+static void print_usage() {
+    printf(
+        "Usage: ./libbench.out {--sizes 1000,100000,1000000} {--repeats N} "
+        "{--filter NAME} {--csv}\n"
+        "Defaults: --sizes 1000,100000,1000000 --repeats 5\n");
+}
+
+int main(int argc, char* argv[]) {
+    size_t sizes[LIB_BENCH_MAX_SIZES] = {1000, 100000, 1000000};
+    int n_sizes = 3;
+    int repeats = 5;
+    char const* filter = NULL;
+    bool is_csv = false;
+
+    for(int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if(strcmp(argv[i], "--sizes") == 0 && has_value) {
+            n_sizes = 0;
+            char* ptr = argv[++i];
+            while(*ptr && n_sizes < LIB_BENCH_MAX_SIZES) {
+                sizes[n_sizes++] = (size_t)strtoull(ptr, &ptr, 10);
+                ptr += *ptr == ',';
+            }
+        } else if(strcmp(argv[i], "--repeats") == 0 && has_value &&
+                  (repeats = atoi(argv[++i])) > 0) {
+            continue;
+        } else if(strcmp(argv[i], "--filter") == 0 && has_value) {
+            filter = argv[++i];
+        } else if(strcmp(argv[i], "--csv") == 0) {
+            is_csv = true;
+        } else {
+            print_usage();
+            return strcmp(argv[i], "-h") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if(is_csv) {
+        printf(
+            "bench,size,ops,median_ns_per_op,best_ns_per_op,mops_per_sec,"
+            "allocs_per_op,frees_per_op\n");
+    } else {
+        printf("%-20s %10s %12s %10s %10s %10s %10s %10s\n", "bench", "size",
+               "ops", "med ns/op", "best ns/op", "Mops/s", "allocs/op",
+               "frees/op");
+    }
+
+    size_t n_benches = sizeof(benches) / sizeof(benches[0]);
+    for(size_t i = 0; i < n_benches; ++i) {
+        if(filter && !strstr(benches[i].name, filter)) {
+            continue;
+        }
+        for(int j = 0; j < n_sizes; ++j) {
+            size_t n = sizes[j];
+            if(n == 0 ||
+               (benches[i].is_quadratic && n > LIB_BENCH_QUADRATIC_CAP)) {
+                continue;
+            }
+            run_bench(&benches[i], n, repeats, is_csv);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
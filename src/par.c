@@ -0,0 +1,328 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <par.h>
+
+typedef struct {
+    pthread_mutex_t lock;
+    dynarr_head tasks;
+    size_t top;
+} par_deque;
+
+typedef struct par_shared par_shared;
+
+typedef struct {
+    int worker_id;
+    par_shared* shared;
+    puzzle_def puzzle;
+    search_state state;
+} par_worker;
+
+struct par_shared {
+    par_settings* settings;
+    par_deque* deques;
+    int n_deques;
+
+    atomic_bool cancel;
+    pthread_mutex_t result_lock;
+    puzzle_def* result_puzzle;
+    bool result_set;
+};
+
+static void apply_prefix(puzzle_def* puzzle, par_task const* task) {
+    for(int i = 0; i < task->n_placements; ++i) {
+        node_placement const* placement = &task->placements[i];
+        place_block(puzzle, placement->tile_type, placement->x_pos,
+                    placement->y_pos);
+    }
+}
+
+static void revert_prefix(puzzle_def* puzzle, par_task const* task) {
+    for(int i = task->n_placements - 1; i >= 0; --i) {
+        node_placement const* placement = &task->placements[i];
+        remove_block(puzzle, placement->tile_type, placement->x_pos,
+                     placement->y_pos);
+    }
+}
+
+// Expands every task by one placement at the first empty cell
+// Tasks whose board is already solved are carried over unchanged
+static void expand_tasks(puzzle_def* puzzle,
+                         par_settings* settings,
+                         dynarr_head* tasks,
+                         dynarr_head* expanded) {
+    par_task* task_array = (par_task*)tasks->ptr_first_elem;
+    for(size_t i = 0; i < tasks->dynarr_size; ++i) {
+        par_task* task = &task_array[i];
+        apply_prefix(puzzle, task);
+
+        point cell = {0};
+        if(!line_scan_hor(puzzle, &cell)) {
+            dynarr_append(expanded, task);
+            revert_prefix(puzzle, task);
+            continue;
+        }
+
+        for(int tile = 1; tile <= puzzle->size; ++tile) {
+            if(settings->break_symmetry &&
+               !is_symmetry_allowed(puzzle, tile, cell.x_index,
+                                    cell.y_index)) {
+                continue;
+            }
+            if(place_block(puzzle, tile, cell.x_index, cell.y_index) !=
+               SUCCESS) {
+                continue;
+            }
+
+            if(is_puzzle_solved(puzzle) ||
+               check_prune_rules(puzzle, settings->prune_rules) == NO_PRUNE) {
+                par_task new_task = *task;
+                node_placement* placement =
+                    &new_task.placements[new_task.n_placements++];
+                placement->tile_type = tile;
+                placement->x_pos = cell.x_index;
+                placement->y_pos = cell.y_index;
+                placement->valid_tiles = 0;
+                dynarr_append(expanded, &new_task);
+            }
+
+            remove_block(puzzle, tile, cell.x_index, cell.y_index);
+        }
+
+        revert_prefix(puzzle, task);
+    }
+}
+
+void par_make_tasks(puzzle_def* puzzle,
+                    dynarr_head* tasks,
+                    par_settings* settings,
+                    size_t min_tasks) {
+    int prefix_depth = settings->prefix_depth;
+    par_task empty_task = {0};
+    dynarr_append(tasks, &empty_task);
+
+    int max_depth = prefix_depth > 0 ? prefix_depth : PAR_MAX_PREFIX;
+    if(max_depth > PAR_MAX_PREFIX) {
+        max_depth = PAR_MAX_PREFIX;
+    }
+
+    for(int depth = 0; depth < max_depth; ++depth) {
+        if(prefix_depth <= 0 && tasks->dynarr_size >= min_tasks) {
+            break;
+        }
+
+        dynarr_head expanded = {0};
+        expanded.elem_size = sizeof(par_task);
+        expanded.dynarr_capacity = tasks->dynarr_size * puzzle->size;
+        dynarr_init(&expanded);
+
+        expand_tasks(puzzle, settings, tasks, &expanded);
+
+        dynarr_free(tasks);
+        *tasks = expanded;
+        if(tasks->dynarr_size == 0) {
+            break;
+        }
+    }
+}
+
+static bool deque_pop_bottom(par_deque* deque, par_task* out) {
+    bool is_ok = false;
+    pthread_mutex_lock(&deque->lock);
+    if(deque->tasks.dynarr_size > deque->top) {
+        --deque->tasks.dynarr_size;
+        memcpy(out,
+               deque->tasks.ptr_first_elem +
+                   deque->tasks.dynarr_size * sizeof(par_task),
+               sizeof(par_task));
+        is_ok = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return is_ok;
+}
+
+static bool deque_steal_top(par_deque* deque, par_task* out) {
+    bool is_ok = false;
+    pthread_mutex_lock(&deque->lock);
+    if(deque->tasks.dynarr_size > deque->top) {
+        memcpy(out,
+               deque->tasks.ptr_first_elem + deque->top * sizeof(par_task),
+               sizeof(par_task));
+        ++deque->top;
+        is_ok = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return is_ok;
+}
+
+static bool next_task(par_worker* worker, par_task* out) {
+    par_shared* shared = worker->shared;
+    if(deque_pop_bottom(&shared->deques[worker->worker_id], out)) {
+        return true;
+    }
+
+    for(int i = 1; i < shared->n_deques; ++i) {
+        int victim = (worker->worker_id + i) % shared->n_deques;
+        if(deque_steal_top(&shared->deques[victim], out)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void worker_solution(search_state* state, void* ctx) {
+    par_worker* worker = ctx;
+    par_shared* shared = worker->shared;
+    par_settings* settings = shared->settings;
+
+    pthread_mutex_lock(&shared->result_lock);
+    if(settings->solution_func) {
+        settings->solution_func(state, settings->solution_ctx);
+    }
+
+    if(settings->mode == SEARCH_FIRST && !shared->result_set) {
+        for(int i = 0; i <= state->depth; ++i) {
+            node_placement* placement = &state->path[i];
+            place_block(shared->result_puzzle, placement->tile_type,
+                        placement->x_pos, placement->y_pos);
+        }
+        shared->result_set = true;
+        atomic_store(&shared->cancel, true);
+    }
+    pthread_mutex_unlock(&shared->result_lock);
+}
+
+static void* worker_run(void* arg) {
+    par_worker* worker = arg;
+    search_state* state = &worker->state;
+
+    par_task task;
+    while(!atomic_load(&worker->shared->cancel) && next_task(worker, &task)) {
+        apply_prefix(&worker->puzzle, &task);
+
+        memcpy(state->path, task.placements,
+               sizeof(node_placement) * task.n_placements);
+        // solved prefixes are reported by dfs_run with the last placement
+        // as the top of the path
+        state->depth = task.n_placements;
+        if(task.n_placements > 0 && is_puzzle_solved(&worker->puzzle)) {
+            --state->depth;
+        }
+
+        dfs_run(state);
+        if(atomic_load(&worker->shared->cancel)) {
+            break;
+        }
+
+        state->depth = 0;
+        revert_prefix(&worker->puzzle, &task);
+    }
+
+    return NULL;
+}
+
+bool par_search(puzzle_def* puzzle, par_settings* settings) {
+    int n_threads = settings->n_threads > 0 ? settings->n_threads : 1;
+
+    dynarr_head tasks = {0};
+    tasks.elem_size = sizeof(par_task);
+    dynarr_init(&tasks);
+    par_make_tasks(puzzle, &tasks, settings,
+                   (size_t)n_threads * PAR_TASKS_PER_THREAD);
+    settings->n_tasks = tasks.dynarr_size;
+
+    par_shared shared = {0};
+    shared.settings = settings;
+    shared.n_deques = n_threads;
+    shared.result_puzzle = puzzle;
+    atomic_init(&shared.cancel, false);
+    pthread_mutex_init(&shared.result_lock, NULL);
+
+    shared.deques = calloc((size_t)n_threads, sizeof(par_deque));
+    par_worker* workers = calloc((size_t)n_threads, sizeof(par_worker));
+    pthread_t* threads = calloc((size_t)n_threads, sizeof(pthread_t));
+    if(!shared.deques || !workers || !threads) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // deal the tasks round-robin
+    par_task* task_array = (par_task*)tasks.ptr_first_elem;
+    for(int i = 0; i < n_threads; ++i) {
+        par_deque* deque = &shared.deques[i];
+        pthread_mutex_init(&deque->lock, NULL);
+        deque->tasks.elem_size = sizeof(par_task);
+        deque->tasks.dynarr_capacity =
+            tasks.dynarr_size / (size_t)n_threads + 1;
+        dynarr_init(&deque->tasks);
+    }
+    for(size_t i = 0; i < tasks.dynarr_size; ++i) {
+        dynarr_append(&shared.deques[i % (size_t)n_threads].tasks,
+                      &task_array[i]);
+    }
+    dynarr_free(&tasks);
+
+    for(int i = 0; i < n_threads; ++i) {
+        par_worker* worker = &workers[i];
+        worker->worker_id = i;
+        worker->shared = &shared;
+
+        copy_puzzle(&worker->puzzle, puzzle);
+
+        dfs_init(&worker->state, &worker->puzzle, settings->mode);
+        worker->state.prune_rules = settings->prune_rules;
+        worker->state.break_symmetry = settings->break_symmetry;
+        worker->state.tt = settings->tt;
+        worker->state.select_func = settings->select_func;
+        worker->state.select_ctx = settings->select_ctx;
+        worker->state.cancel = &shared.cancel;
+        worker->state.solution_func = worker_solution;
+        worker->state.solution_ctx = worker;
+    }
+
+    // puzzle receives the result, so all boards are copied up front
+    for(int i = 0; i < n_threads; ++i) {
+        pthread_create(&threads[i], NULL, worker_run, &workers[i]);
+    }
+
+    settings->n_nodes = 0;
+    settings->n_solutions = 0;
+    settings->n_unique_solutions = 0;
+    settings->n_raw_solutions = 0;
+    memset(settings->n_prunes, 0, sizeof(settings->n_prunes));
+    settings->n_tt_hits = 0;
+    settings->n_tt_misses = 0;
+    for(int i = 0; i < n_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // the deques can only be released once no worker is left to steal
+    for(int i = 0; i < n_threads; ++i) {
+        settings->n_nodes += workers[i].state.n_nodes;
+        settings->n_solutions += workers[i].state.n_solutions;
+        settings->n_unique_solutions += workers[i].state.n_unique_solutions;
+        settings->n_raw_solutions += workers[i].state.n_raw_solutions;
+        for(int rule = 0; rule < N_PRUNE_RULES; ++rule) {
+            settings->n_prunes[rule] += workers[i].state.n_prunes[rule];
+        }
+        settings->n_tt_hits += workers[i].state.n_tt_hits;
+        settings->n_tt_misses += workers[i].state.n_tt_misses;
+
+        dfs_free(&workers[i].state);
+        free_puzzle(&workers[i].puzzle);
+        dynarr_free(&shared.deques[i].tasks);
+        pthread_mutex_destroy(&shared.deques[i].lock);
+    }
+
+    pthread_mutex_destroy(&shared.result_lock);
+    free(threads);
+    free(workers);
+    free(shared.deques);
+
+    return settings->n_solutions > 0;
+}
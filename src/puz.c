@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <puz.h>
 
@@ -24,13 +25,133 @@ void init_puzzle(puzzle_def* puzzle) {
     }
 
     // init Grid
-    puzzle->grid_dimension = (puzzle->size * (puzzle->size + 1)) / 2;
+    puzzle->grid_dimension = PUZZLE_GRID_DIMENSION(puzzle->size);
+    puzzle->kernel = get_puzzle_kernel(puzzle->size);
     int grid_size = puzzle->grid_dimension;
     puzzle->puzzle_grid = calloc(grid_size, sizeof(int*));
     puzzle->puzzle_grid[0] = calloc(grid_size, grid_size * sizeof(int));
     for(int i = 1; i < grid_size; i++) {
         puzzle->puzzle_grid[i] = puzzle->puzzle_grid[0] + i * grid_size;
     }
+
+    puzzle->cell_tiles =
+        calloc((size_t)grid_size * grid_size + 1, sizeof(int));
+    puzzle->is_cell_tiles_valid = true;
+    memset(puzzle->corner_tiles, 0, sizeof(puzzle->corner_tiles));
+
+    // init Occupancy
+    puzzle->n_row_words = PUZZLE_ROW_WORDS(puzzle->size);
+    puzzle->occupancy =
+        calloc((size_t)grid_size * puzzle->n_row_words + 1, sizeof(uint64_t));
+
+    // init Bookkeeping
+    puzzle->n_filled_cells = 0;
+    puzzle->row_fill = calloc((size_t)grid_size + 1, sizeof(int));
+    puzzle->cursor_x = 0;
+    puzzle->cursor_y = 0;
+
+    // init Skyline
+    puzzle->column_height = calloc((size_t)grid_size + 1, sizeof(int));
+    puzzle->skyline = calloc((size_t)grid_size + 1, sizeof(skyline_segment));
+    puzzle->n_segments = grid_size > 0 ? 1 : 0;
+    puzzle->n_skyline_cells = 0;
+    if(puzzle->skyline) {
+        puzzle->skyline[0].x_pos = 0;
+        puzzle->skyline[0].width = grid_size;
+        puzzle->skyline[0].height = 0;
+    }
+
+    if(!puzzle->blocks || !puzzle->puzzle_grid || !puzzle->puzzle_grid[0] ||
+       !puzzle->cell_tiles || !puzzle->occupancy || !puzzle->row_fill ||
+       !puzzle->column_height || !puzzle->skyline) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    reset_state_hash(puzzle);
+}
+
+void free_puzzle(puzzle_def* puzzle) {
+    dynarr_free(puzzle->blocks);
+    free(puzzle->blocks);
+    puzzle->blocks = NULL;
+
+    if(puzzle->puzzle_grid) {
+        free(puzzle->puzzle_grid[0]);
+        free(puzzle->puzzle_grid);
+        puzzle->puzzle_grid = NULL;
+    }
+
+    free(puzzle->cell_tiles);
+    puzzle->cell_tiles = NULL;
+    free(puzzle->occupancy);
+    puzzle->occupancy = NULL;
+    free(puzzle->row_fill);
+    puzzle->row_fill = NULL;
+    free(puzzle->column_height);
+    puzzle->column_height = NULL;
+    free(puzzle->skyline);
+    puzzle->skyline = NULL;
+    free(puzzle->sums_cache);
+    puzzle->sums_cache = NULL;
+}
+
+void copy_puzzle(puzzle_def* dest, puzzle_def* src) {
+    dest->size = src->size;
+    init_puzzle(dest);
+
+    memcpy(dest->blocks->ptr_first_elem, src->blocks->ptr_first_elem,
+           src->blocks->dynarr_size * src->blocks->elem_size);
+
+    int grid_size = src->grid_dimension;
+    memcpy(dest->puzzle_grid[0], src->puzzle_grid[0],
+           (size_t)grid_size * grid_size * sizeof(int));
+    dest->is_cell_tiles_valid = false;
+    memcpy(dest->corner_tiles, src->corner_tiles, sizeof(src->corner_tiles));
+    memcpy(dest->occupancy, src->occupancy,
+           (size_t)grid_size * src->n_row_words * sizeof(uint64_t));
+
+    dest->n_filled_cells = src->n_filled_cells;
+    memcpy(dest->row_fill, src->row_fill, (size_t)grid_size * sizeof(int));
+    dest->cursor_x = src->cursor_x;
+    dest->cursor_y = src->cursor_y;
+
+    memcpy(dest->column_height, src->column_height,
+           (size_t)grid_size * sizeof(int));
+    memcpy(dest->skyline, src->skyline,
+           (size_t)src->n_segments * sizeof(skyline_segment));
+    dest->n_segments = src->n_segments;
+    dest->n_skyline_cells = src->n_skyline_cells;
+    dest->state_hash = src->state_hash;
+}
+
+// The Zobrist keys are derived from the (column, height) and
+// (size, count) pairs by the splitmix64 finalizer instead of a table
+static uint64_t zobrist_key(uint64_t id) {
+    id += 0x9E3779B97F4A7C15ULL;
+    id = (id ^ (id >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    id = (id ^ (id >> 27)) * 0x94D049BB133111EBULL;
+    return id ^ (id >> 31);
+}
+
+static uint64_t height_key(int x_pos, int height) {
+    return zobrist_key(((uint64_t)x_pos << 16) | (uint64_t)height);
+}
+
+static uint64_t pieces_key(int block_id, int n_pieces) {
+    return zobrist_key((1ULL << 40) | ((uint64_t)block_id << 16) |
+                       (uint64_t)n_pieces);
+}
+
+void reset_state_hash(puzzle_def* puzzle) {
+    uint64_t hash = 0;
+    for(int x = 0; x < puzzle->grid_dimension; ++x) {
+        hash ^= height_key(x, puzzle->column_height[x]);
+    }
+    for(int i = 1; i <= puzzle->size; ++i) {
+        hash ^= pieces_key(i, get_n_available_pieces(puzzle, i));
+    }
+    puzzle->state_hash = hash;
 }
 
 int get_n_available_pieces(puzzle_def* puzzle_def, int block_id) {
@@ -38,98 +159,654 @@ int get_n_available_pieces(puzzle_def* puzzle_def, int block_id) {
     return blocks[block_id].free_pieces;
 }
 
-bool is_puzzle_solved(puzzle_def* puzzle) {
-    int** grid = puzzle->puzzle_grid;
-    for(int i = 0; i < puzzle->grid_dimension; ++i) {
-        for(int j = 0; j < puzzle->grid_dimension; ++j) {
-            if(grid[i][j] == 0) {
-                return false;
+// sums |= sums << shift over all words
+static void sums_or_shifted(uint64_t* sums, int shift) {
+    int word_shift = shift / 64;
+    int bit_shift = shift % 64;
+    for(int w = SUBSET_SUM_WORDS - 1; w >= word_shift; --w) {
+        uint64_t shifted = sums[w - word_shift] << bit_shift;
+        if(bit_shift != 0 && w - word_shift > 0) {
+            shifted |= sums[w - word_shift - 1] >> (64 - bit_shift);
+        }
+        sums[w] |= shifted;
+    }
+}
+
+// Bounded subset sum as a bitset DP, the pieces of one size are split
+// into groups of 1, 2, 4, ... so every count takes log2(count) shifts
+static void compute_reachable_sums(puzzle_def* puzzle, uint64_t* sums) {
+    for(int w = 0; w < SUBSET_SUM_WORDS; ++w) {
+        sums[w] = 0;
+    }
+    sums[0] = 1;
+
+    for(int i = 1; i <= puzzle->size; ++i) {
+        int n_pieces = get_n_available_pieces(puzzle, i);
+        for(int group = 1; n_pieces > 0; group *= 2) {
+            int n_group = group < n_pieces ? group : n_pieces;
+            if(i * n_group < SUBSET_SUM_WORDS * 64) {
+                sums_or_shifted(sums, i * n_group);
             }
+            n_pieces -= n_group;
+        }
+    }
+}
+
+void get_reachable_sums(puzzle_def* puzzle, uint64_t* sums) {
+    if(!puzzle->sums_cache) {
+        puzzle->sums_cache =
+            calloc(SUBSET_SUM_CACHE_SIZE, sizeof(subset_sum_entry));
+        if(!puzzle->sums_cache) {
+            perror("calloc failed");
+            exit(EXIT_FAILURE);
         }
     }
 
+    uint64_t key[2] = {0};
+    for(int i = 1; i <= puzzle->size; ++i) {
+        uint64_t n_pieces = (uint64_t)get_n_available_pieces(puzzle, i);
+        key[(i - 1) / 8] |= n_pieces << (8 * ((i - 1) % 8));
+    }
+
+    uint64_t hash = (key[0] ^ (key[1] * 0x9E3779B97F4A7C15ULL)) *
+                    0xBF58476D1CE4E5B9ULL;
+    subset_sum_entry* entry =
+        &puzzle->sums_cache[(hash >> 32) & (SUBSET_SUM_CACHE_SIZE - 1)];
+
+    if(!entry->is_set || entry->key[0] != key[0] || entry->key[1] != key[1]) {
+        compute_reachable_sums(puzzle, entry->sums);
+        entry->key[0] = key[0];
+        entry->key[1] = key[1];
+        entry->is_set = true;
+    }
+
+    memcpy(sums, entry->sums, sizeof(entry->sums));
+}
+
+bool is_reachable_sum(uint64_t const* sums, int value) {
+    if(value < 0 || value >= SUBSET_SUM_WORDS * 64) {
+        return false;
+    }
+    return (sums[value / 64] >> (value % 64)) & 1;
+}
+
+// The kernels are inlined into the functions of every puzzle size
+#define KERNEL_INLINE static inline __attribute__((always_inline))
+
+// Row mask helpers
+// A run of k cells starting at x can span several words of a row, every
+// word is handled with one mask operation. A grid of at most 64 columns has
+// a single word per row, which the kernels below pass as a constant.
+static inline uint64_t run_mask(int bit, int n_bits) {
+    uint64_t ones = n_bits == ROW_WORD_BITS ? ~0ULL : (1ULL << n_bits) - 1;
+    return ones << bit;
+}
+
+KERNEL_INLINE bool row_run_free(uint64_t const* row,
+                                int x_pos,
+                                int length,
+                                int n_row_words) {
+    if(n_row_words == 1) {
+        return !(row[0] & run_mask(x_pos, length));
+    }
+    while(length > 0) {
+        int bit = x_pos % ROW_WORD_BITS;
+        int room = ROW_WORD_BITS - bit;
+        int n_bits = room < length ? room : length;
+        if(row[x_pos / ROW_WORD_BITS] & run_mask(bit, n_bits)) {
+            return false;
+        }
+        x_pos += n_bits;
+        length -= n_bits;
+    }
     return true;
 }
 
-bool placement_resolvable(puzzle_def* puzzle,
-                          int block_id,
-                          int x_pos,
-                          int y_pos) {
-    if(x_pos > puzzle->grid_dimension - 1 ||
-       x_pos + block_id - 1 > puzzle->grid_dimension - 1 ||
-       y_pos > puzzle->grid_dimension - 1 ||
-       y_pos + block_id - 1 > puzzle->grid_dimension - 1) {
+KERNEL_INLINE void row_run_set(uint64_t* row,
+                               int x_pos,
+                               int length,
+                               int n_row_words) {
+    if(n_row_words == 1) {
+        row[0] |= run_mask(x_pos, length);
+        return;
+    }
+    while(length > 0) {
+        int bit = x_pos % ROW_WORD_BITS;
+        int room = ROW_WORD_BITS - bit;
+        int n_bits = room < length ? room : length;
+        row[x_pos / ROW_WORD_BITS] |= run_mask(bit, n_bits);
+        x_pos += n_bits;
+        length -= n_bits;
+    }
+}
+
+KERNEL_INLINE void row_run_clear(uint64_t* row,
+                                 int x_pos,
+                                 int length,
+                                 int n_row_words) {
+    if(n_row_words == 1) {
+        row[0] &= ~run_mask(x_pos, length);
+        return;
+    }
+    while(length > 0) {
+        int bit = x_pos % ROW_WORD_BITS;
+        int room = ROW_WORD_BITS - bit;
+        int n_bits = room < length ? room : length;
+        row[x_pos / ROW_WORD_BITS] &= ~run_mask(bit, n_bits);
+        x_pos += n_bits;
+        length -= n_bits;
+    }
+}
+
+// Number of free cells from x_pos on, counted up to max_length
+KERNEL_INLINE int row_free_run(uint64_t const* row,
+                               int x_pos,
+                               int max_length,
+                               int n_row_words) {
+    int length = 0;
+    if(n_row_words == 1) {
+        uint64_t taken = row[0] >> x_pos;
+        length = taken != 0 ? __builtin_ctzll(taken) : max_length;
+        return length < max_length ? length : max_length;
+    }
+    while(length < max_length) {
+        int bit = x_pos % ROW_WORD_BITS;
+        uint64_t taken = row[x_pos / ROW_WORD_BITS] >> bit;
+        if(taken != 0) {
+            length += __builtin_ctzll(taken);
+            break;
+        }
+        length += ROW_WORD_BITS - bit;
+        x_pos += ROW_WORD_BITS - bit;
+    }
+    return length < max_length ? length : max_length;
+}
+
+KERNEL_INLINE uint64_t* kernel_row(puzzle_def* puzzle,
+                                   int y_pos,
+                                   int n_row_words) {
+    return puzzle->occupancy + (size_t)y_pos * n_row_words;
+}
+
+KERNEL_INLINE bool kernel_cell_occupied(puzzle_def* puzzle,
+                                        int x_pos,
+                                        int y_pos,
+                                        int n_row_words) {
+    uint64_t const* row = kernel_row(puzzle, y_pos, n_row_words);
+    return (row[x_pos / ROW_WORD_BITS] >> (x_pos % ROW_WORD_BITS)) & 1;
+}
+
+uint64_t* get_occupancy_row(puzzle_def* puzzle, int y_pos) {
+    return kernel_row(puzzle, y_pos, puzzle->n_row_words);
+}
+
+bool is_cell_occupied(puzzle_def* puzzle, int x_pos, int y_pos) {
+    return kernel_cell_occupied(puzzle, x_pos, y_pos, puzzle->n_row_words);
+}
+
+bool is_puzzle_solved(puzzle_def* puzzle) {
+    return puzzle->n_filled_cells ==
+           puzzle->grid_dimension * puzzle->grid_dimension;
+}
+
+bool get_first_empty_cell(puzzle_def* puzzle, int* x_pos, int* y_pos) {
+    if(puzzle->cursor_y >= puzzle->grid_dimension) {
+        return false;
+    }
+
+    *x_pos = puzzle->cursor_x;
+    *y_pos = puzzle->cursor_y;
+    return true;
+}
+
+// Moves the cursor forward to the next empty cell
+// Full rows are skipped by their fill count, in the first row that is not
+// full the free cell is found word by word
+KERNEL_INLINE void advance_cursor(puzzle_def* puzzle,
+                                  int grid_size,
+                                  int n_row_words) {
+    int y_pos = puzzle->cursor_y;
+    int x_pos = puzzle->cursor_x;
+
+    while(y_pos < grid_size && puzzle->row_fill[y_pos] == grid_size) {
+        ++y_pos;
+        x_pos = 0;
+    }
+    if(y_pos == grid_size) {
+        puzzle->cursor_x = 0;
+        puzzle->cursor_y = grid_size;
+        return;
+    }
+
+    uint64_t const* row = kernel_row(puzzle, y_pos, n_row_words);
+    for(int w = x_pos / ROW_WORD_BITS; w < n_row_words; ++w) {
+        uint64_t free_cells = ~row[w];
+        if(w == x_pos / ROW_WORD_BITS) {
+            free_cells &= ~0ULL << (x_pos % ROW_WORD_BITS);
+        }
+        if(free_cells != 0) {
+            x_pos = w * ROW_WORD_BITS + __builtin_ctzll(free_cells);
+            break;
+        }
+    }
+
+    puzzle->cursor_x = x_pos;
+    puzzle->cursor_y = y_pos;
+}
+
+KERNEL_INLINE bool resolvable_kernel(puzzle_def* puzzle,
+                                     int block_id,
+                                     int x_pos,
+                                     int y_pos,
+                                     int grid_size,
+                                     int n_row_words) {
+    if(x_pos > grid_size - 1 || x_pos + block_id - 1 > grid_size - 1 ||
+       y_pos > grid_size - 1 || y_pos + block_id - 1 > grid_size - 1) {
         return false;
     }
-    int** grid = puzzle->puzzle_grid;
     for(int i = 0; i < block_id; ++i) {
-        for(int j = 0; j < block_id; ++j) {
-            if(grid[y_pos + i][x_pos + j] != 0) {
-                return false;
-            }
+        if(!row_run_free(kernel_row(puzzle, y_pos + i, n_row_words), x_pos,
+                         block_id, n_row_words)) {
+            return false;
         }
     }
 
     return true;
 }
 
-RETURN_CODES place_block(puzzle_def* puzzle,
-                         int block_id,
-                         int x_pos,
-                         int y_pos) {
+// The free run of every row below the cell caps the side, the rows are
+// read until the side is reached, so a side of k costs k row lookups
+KERNEL_INLINE int max_fit_kernel(puzzle_def* puzzle,
+                                 int x_pos,
+                                 int y_pos,
+                                 int grid_size,
+                                 int n_row_words) {
+    int max_fit = puzzle->size;
+    max_fit = grid_size - x_pos < max_fit ? grid_size - x_pos : max_fit;
+    max_fit = grid_size - y_pos < max_fit ? grid_size - y_pos : max_fit;
+
+    for(int i = 0; i < max_fit; ++i) {
+        int run = row_free_run(kernel_row(puzzle, y_pos + i, n_row_words),
+                               x_pos, max_fit, n_row_words);
+        // the rows above all have room for a side of i
+        if(run <= i) {
+            return i;
+        }
+        max_fit = run;
+    }
+    return max_fit;
+}
+
+// Rebuilds the segments covering the columns [x_pos, x_pos + width) from
+// column_height. The neighbouring segments are included so runs that now
+// have the same height get merged.
+static void update_skyline(puzzle_def* puzzle, int x_pos, int width) {
+    skyline_segment* skyline = puzzle->skyline;
+
+    int first = 0;
+    while(skyline[first].x_pos + skyline[first].width <= x_pos) {
+        ++first;
+    }
+    int last = first;
+    while(skyline[last].x_pos + skyline[last].width < x_pos + width) {
+        ++last;
+    }
+    if(first > 0) {
+        --first;
+    }
+    if(last < puzzle->n_segments - 1) {
+        ++last;
+    }
+
+    int x_start = skyline[first].x_pos;
+    int x_end = skyline[last].x_pos + skyline[last].width;
+
+    int n_new = 1;
+    for(int x = x_start + 1; x < x_end; ++x) {
+        if(puzzle->column_height[x] != puzzle->column_height[x - 1]) {
+            ++n_new;
+        }
+    }
+
+    int n_old = last - first + 1;
+    memmove(&skyline[first + n_new], &skyline[last + 1],
+            (size_t)(puzzle->n_segments - last - 1) * sizeof(skyline_segment));
+    puzzle->n_segments += n_new - n_old;
+
+    skyline_segment* segment = &skyline[first];
+    segment->x_pos = x_start;
+    segment->width = 1;
+    segment->height = puzzle->column_height[x_start];
+    for(int x = x_start + 1; x < x_end; ++x) {
+        if(puzzle->column_height[x] == segment->height) {
+            ++segment->width;
+        } else {
+            ++segment;
+            segment->x_pos = x;
+            segment->width = 1;
+            segment->height = puzzle->column_height[x];
+        }
+    }
+}
+
+// Records tile (or 0) on the corners of the grid the block covers
+KERNEL_INLINE void set_corner_tiles(puzzle_def* puzzle,
+                                    int block_id,
+                                    int x_pos,
+                                    int y_pos,
+                                    int tile,
+                                    int grid_size) {
+    if(x_pos != 0 && y_pos != 0 && x_pos + block_id != grid_size &&
+       y_pos + block_id != grid_size) {
+        return;
+    }
+    bool is_left = x_pos == 0;
+    bool is_right = x_pos + block_id == grid_size;
+    if(y_pos == 0) {
+        if(is_left) {
+            puzzle->corner_tiles[0] = tile;
+        }
+        if(is_right) {
+            puzzle->corner_tiles[1] = tile;
+        }
+    }
+    if(y_pos + block_id == grid_size) {
+        if(is_left) {
+            puzzle->corner_tiles[2] = tile;
+        }
+        if(is_right) {
+            puzzle->corner_tiles[3] = tile;
+        }
+    }
+}
+
+KERNEL_INLINE RETURN_CODES place_kernel(puzzle_def* puzzle,
+                                        int block_id,
+                                        int x_pos,
+                                        int y_pos,
+                                        int grid_size,
+                                        int n_row_words) {
     if(get_n_available_pieces(puzzle, block_id) <= 0) {
         return NO_FREE_PIECES;
     }
 
-    if(!placement_resolvable(puzzle, block_id, x_pos, y_pos)) {
+    if(!resolvable_kernel(puzzle, block_id, x_pos, y_pos, grid_size,
+                          n_row_words)) {
         return CONFLICT_ON_GRID;
     }
 
-    int** grid = puzzle->puzzle_grid;
     for(int i = 0; i < block_id; ++i) {
-        for(int j = 0; j < block_id; ++j) {
-            grid[y_pos + i][x_pos + j] = block_id;
+        row_run_set(kernel_row(puzzle, y_pos + i, n_row_words), x_pos,
+                    block_id, n_row_words);
+        puzzle->row_fill[y_pos + i] += block_id;
+    }
+    puzzle->n_filled_cells += block_id * block_id;
+    puzzle->puzzle_grid[y_pos][x_pos] = block_id;
+    set_corner_tiles(puzzle, block_id, x_pos, y_pos, block_id, grid_size);
+    puzzle->is_cell_tiles_valid = false;
+
+    // only a block that covers the cursor can move it
+    if(y_pos == puzzle->cursor_y && x_pos == puzzle->cursor_x) {
+        advance_cursor(puzzle, grid_size, n_row_words);
+    }
+
+    // a block on top of a column extends it, possibly down to blocks that
+    // were placed below it earlier
+    bool skyline_changed = false;
+    for(int j = x_pos; j < x_pos + block_id; ++j) {
+        int* height = &puzzle->column_height[j];
+        if(*height != y_pos) {
+            continue;
+        }
+        puzzle->state_hash ^= height_key(j, *height);
+        *height = y_pos + block_id;
+        while(*height < grid_size &&
+              kernel_cell_occupied(puzzle, j, *height, n_row_words)) {
+            ++*height;
         }
+        puzzle->state_hash ^= height_key(j, *height);
+        puzzle->n_skyline_cells += *height - y_pos;
+        skyline_changed = true;
+    }
+    if(skyline_changed) {
+        update_skyline(puzzle, x_pos, block_id);
+    }
+
+    block_def* blocks = (block_def*)puzzle->blocks->ptr_first_elem;
+    int n_pieces = blocks[block_id].free_pieces--;
+    puzzle->state_hash ^=
+        pieces_key(block_id, n_pieces) ^ pieces_key(block_id, n_pieces - 1);
+    return SUCCESS;
+}
+
+// The block has to be recorded at its top left cell, blocks do not overlap
+// and the record is cleared on removal, so it is the block on the board
+KERNEL_INLINE RETURN_CODES remove_kernel(puzzle_def* puzzle,
+                                         int block_id,
+                                         int x_pos,
+                                         int y_pos,
+                                         int grid_size,
+                                         int n_row_words) {
+    if(!kernel_cell_occupied(puzzle, x_pos, y_pos, n_row_words)) {
+        return NO_BLOCK_AT_POSITION;
     }
+    if(x_pos + block_id > grid_size || y_pos + block_id > grid_size) {
+        return CONFLICTING_BLOCK_TYPES;
+    }
+
+    if(puzzle->puzzle_grid[y_pos][x_pos] != block_id) {
+        return CONFLICTING_BLOCK_TYPES;
+    }
+
+    for(int i = 0; i < block_id; ++i) {
+        row_run_clear(kernel_row(puzzle, y_pos + i, n_row_words), x_pos,
+                      block_id, n_row_words);
+        puzzle->row_fill[y_pos + i] -= block_id;
+    }
+    puzzle->n_filled_cells -= block_id * block_id;
+    puzzle->puzzle_grid[y_pos][x_pos] = 0;
+    set_corner_tiles(puzzle, block_id, x_pos, y_pos, 0, grid_size);
+    puzzle->is_cell_tiles_valid = false;
+
+    // the top left cell is the first cell of the block in row-major order
+    if(y_pos < puzzle->cursor_y ||
+       (y_pos == puzzle->cursor_y && x_pos < puzzle->cursor_x)) {
+        puzzle->cursor_x = x_pos;
+        puzzle->cursor_y = y_pos;
+    }
+
+    bool skyline_changed = false;
+    for(int j = x_pos; j < x_pos + block_id; ++j) {
+        if(puzzle->column_height[j] > y_pos) {
+            puzzle->state_hash ^= height_key(j, puzzle->column_height[j]) ^
+                                  height_key(j, y_pos);
+            puzzle->n_skyline_cells -= puzzle->column_height[j] - y_pos;
+            puzzle->column_height[j] = y_pos;
+            skyline_changed = true;
+        }
+    }
+    if(skyline_changed) {
+        update_skyline(puzzle, x_pos, block_id);
+    }
+
     block_def* blocks = (block_def*)puzzle->blocks->ptr_first_elem;
-    --blocks[block_id].free_pieces;
+    int n_pieces = blocks[block_id].free_pieces++;
+    puzzle->state_hash ^=
+        pieces_key(block_id, n_pieces) ^ pieces_key(block_id, n_pieces + 1);
     return SUCCESS;
 }
 
+// One kernel per puzzle size, grid_size and n_row_words are either
+// constants or read from the puzzle by the generic kernel
+#define DEFINE_PUZZLE_KERNEL(name, grid_size, n_row_words)                    \
+    static bool resolvable_##name(puzzle_def* puzzle, int block_id,           \
+                                  int x_pos, int y_pos) {                     \
+        return resolvable_kernel(puzzle, block_id, x_pos, y_pos, grid_size,   \
+                                 n_row_words);                                \
+    }                                                                         \
+    static int max_fit_##name(puzzle_def* puzzle, int x_pos, int y_pos) {     \
+        return max_fit_kernel(puzzle, x_pos, y_pos, grid_size, n_row_words);  \
+    }                                                                         \
+    static RETURN_CODES place_##name(puzzle_def* puzzle, int block_id,        \
+                                     int x_pos, int y_pos) {                  \
+        return place_kernel(puzzle, block_id, x_pos, y_pos, grid_size,        \
+                            n_row_words);                                     \
+    }                                                                         \
+    static RETURN_CODES remove_##name(puzzle_def* puzzle, int block_id,       \
+                                      int x_pos, int y_pos) {                 \
+        return remove_kernel(puzzle, block_id, x_pos, y_pos, grid_size,       \
+                             n_row_words);                                    \
+    }                                                                         \
+    static puzzle_kernel const kernel_##name = {                              \
+        resolvable_##name, max_fit_##name, place_##name, remove_##name}
+
+#define DEFINE_SIZE_KERNEL(size)                                              \
+    DEFINE_PUZZLE_KERNEL(size, PUZZLE_GRID_DIMENSION(size),                   \
+                         PUZZLE_ROW_WORDS(size))
+
+DEFINE_PUZZLE_KERNEL(generic, puzzle->grid_dimension, puzzle->n_row_words);
+DEFINE_SIZE_KERNEL(8);
+DEFINE_SIZE_KERNEL(9);
+DEFINE_SIZE_KERNEL(10);
+DEFINE_SIZE_KERNEL(11);
+DEFINE_SIZE_KERNEL(12);
+
+puzzle_kernel const* get_puzzle_kernel(int size) {
+    switch(size) {
+        case 8:
+            return &kernel_8;
+        case 9:
+            return &kernel_9;
+        case 10:
+            return &kernel_10;
+        case 11:
+            return &kernel_11;
+        case 12:
+            return &kernel_12;
+        default:
+            return &kernel_generic;
+    }
+}
+
+bool placement_resolvable(puzzle_def* puzzle,
+                          int block_id,
+                          int x_pos,
+                          int y_pos) {
+    return puzzle->kernel->placement_resolvable(puzzle, block_id, x_pos,
+                                                y_pos);
+}
+
+int get_max_fit(puzzle_def* puzzle, int x_pos, int y_pos) {
+    return puzzle->kernel->get_max_fit(puzzle, x_pos, y_pos);
+}
+
+RETURN_CODES place_block(puzzle_def* puzzle,
+                         int block_id,
+                         int x_pos,
+                         int y_pos) {
+    return puzzle->kernel->place_block(puzzle, block_id, x_pos, y_pos);
+}
+
 RETURN_CODES remove_block(puzzle_def* puzzle,
                           int block_id,
                           int x_pos,
                           int y_pos) {
-    int** grid = puzzle->puzzle_grid;
-    if(grid[y_pos][x_pos] == 0) {
-        return NO_BLOCK_AT_POSITION;
+    return puzzle->kernel->remove_block(puzzle, block_id, x_pos, y_pos);
+}
+
+void transform_cell(int transform, int grid_size, int* x_pos, int* y_pos) {
+    if(transform & 4) {
+        int buffer = *x_pos;
+        *x_pos = *y_pos;
+        *y_pos = buffer;
     }
-    for(int i = 0; i < block_id; ++i) {
-        for(int j = 0; j < block_id; ++j) {
-            if(grid[y_pos + i][x_pos + j] != block_id) {
-                return CONFLICTING_BLOCK_TYPES;
+    if(transform & 1) {
+        *x_pos = grid_size - 1 - *x_pos;
+    }
+    if(transform & 2) {
+        *y_pos = grid_size - 1 - *y_pos;
+    }
+}
+
+// Fills every block recorded on puzzle_grid into cell_tiles
+static void rebuild_cell_tiles(puzzle_def* puzzle) {
+    int grid_size = puzzle->grid_dimension;
+    memset(puzzle->cell_tiles, 0, (size_t)grid_size * grid_size * sizeof(int));
+    for(int i = 0; i < grid_size; ++i) {
+        for(int j = 0; j < grid_size; ++j) {
+            int tile = puzzle->puzzle_grid[i][j];
+            for(int y = i; y < i + tile; ++y) {
+                for(int x = j; x < j + tile; ++x) {
+                    puzzle->cell_tiles[y * grid_size + x] = tile;
+                }
             }
         }
     }
+    puzzle->is_cell_tiles_valid = true;
+}
 
-    for(int i = 0; i < block_id; ++i) {
-        for(int j = 0; j < block_id; ++j) {
-            grid[y_pos + i][x_pos + j] = 0;
+int get_cell_tile(puzzle_def* puzzle, int x_pos, int y_pos) {
+    if(!puzzle->is_cell_tiles_valid) {
+        rebuild_cell_tiles(puzzle);
+    }
+    return puzzle->cell_tiles[y_pos * puzzle->grid_dimension + x_pos];
+}
+
+int get_transformed_tile(puzzle_def* puzzle,
+                         int transform,
+                         int x_pos,
+                         int y_pos) {
+    transform_cell(transform, puzzle->grid_dimension, &x_pos, &y_pos);
+    return get_cell_tile(puzzle, x_pos, y_pos);
+}
+
+// Row-major lexicographic comparison of two transformed grids
+// The tile sizes of every cell determine the tiling, a region of size k
+// cells can only be covered by k x k blocks in one way
+int compare_transforms(puzzle_def* puzzle, int transform_a, int transform_b) {
+    for(int i = 0; i < puzzle->grid_dimension; ++i) {
+        for(int j = 0; j < puzzle->grid_dimension; ++j) {
+            int tile_a = get_transformed_tile(puzzle, transform_a, j, i);
+            int tile_b = get_transformed_tile(puzzle, transform_b, j, i);
+            if(tile_a != tile_b) {
+                return tile_a < tile_b ? -1 : 1;
+            }
         }
     }
-    block_def* blocks = (block_def*)puzzle->blocks->ptr_first_elem;
-    ++blocks[block_id].free_pieces;
-    return SUCCESS;
+
+    return 0;
+}
+
+int get_canonical_transform(puzzle_def* puzzle) {
+    int canonical = 0;
+    for(int transform = 1; transform < N_SYMMETRIES; ++transform) {
+        if(compare_transforms(puzzle, transform, canonical) < 0) {
+            canonical = transform;
+        }
+    }
+    return canonical;
+}
+
+// The tiles are chained through the Zobrist mixer in row-major order
+uint64_t get_canonical_fingerprint(puzzle_def* puzzle) {
+    int transform = get_canonical_transform(puzzle);
+    uint64_t hash = (uint64_t)puzzle->size;
+    for(int i = 0; i < puzzle->grid_dimension; ++i) {
+        for(int j = 0; j < puzzle->grid_dimension; ++j) {
+            int tile = get_transformed_tile(puzzle, transform, j, i);
+            hash = zobrist_key(hash ^ (uint64_t)tile);
+        }
+    }
+    return hash;
 }
 
 void print_grid(puzzle_def* puzzle, FILE* file_ptr) {
     if(file_ptr == NULL)
         file_ptr = stdout;
 
-    int** grid = puzzle->puzzle_grid;
     for(int i = 0; i < puzzle->grid_dimension; ++i) {
         for(int j = 0; j < puzzle->grid_dimension; ++j) {
-            fprintf(file_ptr, "%d|", grid[i][j]);
+            fprintf(file_ptr, "%d|", get_cell_tile(puzzle, j, i));
         }
         fprintf(file_ptr, "\n");
     }
@@ -0,0 +1,46 @@
+#include <rng.h>
+
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+void rng_seed(rng_state* rng, uint64_t seed) {
+    for(int i = 0; i < 4; ++i) {
+        rng->s[i] = splitmix64(&seed);
+    }
+}
+
+uint64_t rng_next(rng_state* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+// Lemire's multiply-shift, the bias is below 2^-32 for the small n used
+int rng_below(rng_state* rng, int n) {
+    return (int)(((rng_next(rng) >> 32) * (uint64_t)n) >> 32);
+}
+
+int rng_select_bit(rng_state* rng, uint16_t mask) {
+    int nth = rng_below(rng, __builtin_popcount(mask));
+    for(int i = 0; i < nth; ++i) {
+        mask &= mask - 1;
+    }
+    return __builtin_ctz(mask);
+}
@@ -0,0 +1,72 @@
+#include <string.h>
+
+#include <sel.h>
+
+int sel_random(puzzle_def* puzzle, uint16_t valid_tiles, void* ctx) {
+    return rng_select_bit((rng_state*)ctx, valid_tiles) + 1;
+}
+
+int sel_largest(puzzle_def* puzzle, uint16_t valid_tiles, void* ctx) {
+    // valid_tiles is promoted to a 32 bit int
+    return 32 - __builtin_clz(valid_tiles);
+}
+
+int sel_smallest(puzzle_def* puzzle, uint16_t valid_tiles, void* ctx) {
+    return __builtin_ctz(valid_tiles) + 1;
+}
+
+int sel_most_pieces(puzzle_def* puzzle, uint16_t valid_tiles, void* ctx) {
+    int selected_tile = 0;
+    int max_pieces = -1;
+    while(valid_tiles) {
+        int tile = __builtin_ctz(valid_tiles) + 1;
+        valid_tiles &= valid_tiles - 1;
+
+        // the tiles come in ascending order, >= hands ties to the larger
+        int n_pieces = get_n_available_pieces(puzzle, tile);
+        bool is_more = n_pieces >= max_pieces;
+        selected_tile = is_more ? tile : selected_tile;
+        max_pieces = is_more ? n_pieces : max_pieces;
+    }
+    return selected_tile;
+}
+
+SELECT_F_PTR sel_func(SELECT_STRATEGY strategy) {
+    switch(strategy) {
+        case SELECT_RANDOM:
+            return sel_random;
+        case SELECT_LARGEST:
+            return sel_largest;
+        case SELECT_SMALLEST:
+            return sel_smallest;
+        case SELECT_MOST_PIECES:
+            return sel_most_pieces;
+        default:
+            return NULL;
+    }
+}
+
+char const* sel_name(SELECT_STRATEGY strategy) {
+    switch(strategy) {
+        case SELECT_RANDOM:
+            return "random";
+        case SELECT_LARGEST:
+            return "largest";
+        case SELECT_SMALLEST:
+            return "smallest";
+        case SELECT_MOST_PIECES:
+            return "pieces";
+        default:
+            return "none";
+    }
+}
+
+bool sel_parse(char const* name, SELECT_STRATEGY* strategy) {
+    for(int i = 0; i < N_SELECT_STRATEGIES; ++i) {
+        if(strcmp(name, sel_name((SELECT_STRATEGY)i)) == 0) {
+            *strategy = (SELECT_STRATEGY)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -15,9 +15,19 @@
 #include <signal.h>
 #include <sys/stat.h>
 
+#include <ckpt.h>
+#include <dfs.h>
+#include <dlx.h>
+#include <frame.h>
 #include <limits.h>
+#include <par.h>
 #include <puz.h>
+#include <rng.h>
+#include <sel.h>
 #include <sol.h>
+#include <stream.h>
+#include <telem.h>
+#include <tt.h>
 #include <vis.h>
 
 FILE* log_fptr;
@@ -25,6 +35,59 @@ FILE* tree_fptr;
 
 bool print_full_log;
 bool visualizer_set;
+bool enumerate_set;
+// 0 := classic single threaded tree search
+int n_threads;
+int prune_rules;
+uint64_t prune_hits[N_PRUNE_RULES];
+bool symmetry_set;
+// exact cover engine instead of the placement DFS
+bool dlx_set;
+// 0 := no transposition table
+size_t tt_size_mb;
+TT_POLICY tt_policy;
+tt_table transposition_table;
+uint64_t tt_hits;
+uint64_t tt_misses;
+// all randomness of a run is drawn from solver_rng, seeded with seed
+uint64_t seed;
+bool seed_set;
+rng_state solver_rng;
+// picks the next tile to try, random unless --select is given, the dfs
+// engines try the tiles in ascending order by default
+SELECT_STRATEGY select_strategy;
+bool select_set;
+SELECT_F_PTR tile_select;
+RESTART_STRATEGY restart_strategy;
+uint64_t restart_base;
+// optional, machine-readable summary of the run
+char const* stats_path;
+// The classic search and the single threaded enumeration write a
+// checkpoint every checkpoint_interval seconds and on SIGINT/SIGTERM, a run
+// started with --resume continues from one
+char const* checkpoint_path;
+char const* resume_path;
+double checkpoint_interval;
+double next_checkpoint_time;
+checkpoint resume_state;
+volatile sig_atomic_t stop_requested;
+bool is_interrupted;
+double prior_cpu_time;
+clock_t search_begin;
+// optional, enumerated solutions are written to a binary solution stream
+char const* solutions_path;
+stream_writer solution_stream;
+// optional, live counters of a running search, see telem.h
+char const* telemetry_path;
+char const* telemetry_socket;
+double telemetry_interval;
+bool telemetry_set;
+telem_state telemetry;
+uint64_t n_backtracks;
+int deepest_depth;
+// The visualizer draws snapshots of the search path on its own thread
+frame_state vis_frames;
+int vis_fps;
 VIS_F_PTR grid_prep_func;
 VIS_F_PTR grid_render_func;
 VIS_F_PTR grid_reset_func;
@@ -35,40 +98,70 @@ VIS_SET_C_PTR block_set_color_func;
 
 puzzle_def* my_puzzle;
 
+// The classic search keeps its current path in search_path, one entry per
+// placed tile. The explored tree is only recorded for printTree, up to
+// tree_cap nodes, path_records holds the recorded node of every path entry.
+// Unless fulltree_set the subtree of an exhausted placement is pruned
+bool stack_set;
+bool fulltree_set;
+uint64_t n_pruned_nodes;
+bool tree_cap_set;
+size_t tree_cap;
+node_placement* search_path;
+tree_node** path_records;
+int path_depth;
+
 tree_head placement_record;
+arena_head placement_arena;
 tree_op_res tree_result;
 size_t node_size;
-tree_node* last_placement;
 
 int root_tile;
 
-// the bool valid_tiles[] array describes all the tiles
-// that have been attempted as children
-// if it is exhausted then the tree descent has to move
-// to the parent of the selected node
-typedef struct {
-    uint8_t tile_type;
-    uint8_t x_pos;
-    uint8_t y_pos;
-    uint16_t valid_tiles;
-} node_placement;
-
 bool is_solvable;
 bool is_solved;
-int loop_n;
+uint64_t loop_n;
 
 typedef enum { NODE_PARTRIDGE = 1001 } my_node_types;
 
-int random_tile_select(uint16_t filter, int max_tile_size);
-int largest_tile_select(uint16_t filter, int max_tile_size);
-
-bool line_scan_hor(puzzle_def* puzzle, point* result);
-bool find_smallest_gap(puzzle_def* puzzle, gap_search_result* res_struct);
-bool is_solvable_gap_cond(puzzle_def* puzzle);
+// iterations between two looks at the clock for a due checkpoint
+#define CHECKPOINT_CHECK_PERIOD 4096
+#define CHECKPOINT_DEFAULT_INTERVAL 300.0
 
 uint16_t set_exhausted_tiles(uint16_t valid_tiles);
 int n_ok_tile_types(uint16_t valid_tiles);
 
+void run_enumeration(int puzzle_type);
+void run_first_search(int puzzle_type);
+void log_enumerated_solution(search_state* state, void* ctx);
+void record_solution(search_state* state, void* ctx);
+void print_enumeration_progress(search_state* state, void* ctx);
+double wall_time_seconds();
+void print_prune_hits(uint64_t const* hits, FILE* file_ptr);
+void publish_search_telemetry();
+void publish_state_telemetry(search_state* state, void* ctx);
+void print_tt_stats(uint64_t hits, uint64_t misses, FILE* file_ptr);
+
+typedef struct {
+    char const* mode;
+    int puzzle_type;
+    bool is_solved;
+    uint64_t n_nodes;
+    uint64_t n_solutions;
+    size_t tree_size;
+    double wall_time;
+    double cpu_time;
+} run_stats;
+void write_run_stats(run_stats const* stats);
+
+void restore_checkpoint(checkpoint const* ckpt);
+void save_checkpoint();
+void restore_enumeration(search_state* state, checkpoint const* ckpt);
+void save_enumeration_checkpoint(search_state* state);
+void check_enumeration_checkpoint(search_state* state, void* ctx);
+void run_checkpointed_enumeration(search_state* state);
+void request_stop(int signum);
+
 void handle_input(int argc, char** argv, int* puzzle_type);
 int is_integer(const char* arg);
 void printWinningBranch(FILE* file_ptr);
@@ -80,15 +173,28 @@ void printTree(tree_node* ptr_node,
                FILE* file_ptr);
 
 void setup(int puzzle_type) {
-    srand(time(NULL));
-
     my_puzzle = calloc(1, sizeof(puzzle_def));
 
     my_puzzle->size = puzzle_type;
     init_puzzle(my_puzzle);
 
     node_size = sizeof(node_placement);
-    tree_init(&placement_record);
+    arena_init(&placement_arena, 0);
+    tree_init_arena(&placement_record, &placement_arena);
+
+    int max_depth = dfs_max_depth(puzzle_type);
+    search_path = calloc((size_t)max_depth + 1, sizeof(node_placement));
+    path_records = calloc((size_t)max_depth + 1, sizeof(tree_node*));
+    if(!search_path || !path_records) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    loop_n = 0;
+    if(resume_path) {
+        restore_checkpoint(&resume_state);
+        return;
+    }
 
     // TODO change to dummy node
     // place root node
@@ -96,26 +202,238 @@ void setup(int puzzle_type) {
     if(puzzle_type <= 4) {
         min_Tile = 1;
     }
-    int selected_tile = rand() % (puzzle_type + 1 - min_Tile) + min_Tile;
+    int selected_tile =
+        rng_below(&solver_rng, puzzle_type + 1 - min_Tile) + min_Tile;
     uint16_t valid_tiles = 0xFFFF;
 
     place_block(my_puzzle, selected_tile, 0, 0);
     if(print_full_log)
         fprintf(log_fptr, "Placed Root tile: %d\n", selected_tile);
 
-    node_placement* node_buffer = malloc(node_size);
-    node_buffer->tile_type = selected_tile;
-    node_buffer->x_pos = 0;
-    node_buffer->y_pos = 0;
-    node_buffer->valid_tiles = valid_tiles;
-
-    tree_node_root(&tree_result, &placement_record, NODE_PARTRIDGE, node_size,
-                   node_buffer);
-    last_placement = tree_result.node_ptr;
-    free(node_buffer);
+    path_depth = 0;
+    search_path[0].tile_type = selected_tile;
+    search_path[0].x_pos = 0;
+    search_path[0].y_pos = 0;
+    search_path[0].valid_tiles = valid_tiles;
+
+    path_records[0] = NULL;
+    if(tree_cap > 0) {
+        tree_node_root(&tree_result, &placement_record, NODE_PARTRIDGE,
+                       node_size, &search_path[0]);
+        path_records[0] = tree_result.node_ptr;
+    }
     root_tile = selected_tile;
 }
 
+// Places the path of the checkpoint on the empty board and takes over its
+// counters and PRNG state, the recorded tree starts with the path
+void restore_checkpoint(checkpoint const* ckpt) {
+    for(int depth = 0; depth <= ckpt->path_depth; ++depth) {
+        node_placement placement = ckpt->path[depth];
+        if(place_block(my_puzzle, placement.tile_type, placement.x_pos,
+                       placement.y_pos) != SUCCESS) {
+            printf("The checkpoint does not fit the puzzle.\n");
+            exit(EXIT_FAILURE);
+        }
+        search_path[depth] = placement;
+
+        path_records[depth] = NULL;
+        if(depth == 0 && tree_cap > 0) {
+            tree_node_root(&tree_result, &placement_record, NODE_PARTRIDGE,
+                           node_size, &search_path[0]);
+            path_records[0] = tree_result.node_ptr;
+        } else if(depth > 0 && path_records[depth - 1] &&
+                  placement_record.tree_size < tree_cap) {
+            tree_node_add(&tree_result, &placement_record,
+                          path_records[depth - 1], NODE_PARTRIDGE, node_size,
+                          &search_path[depth]);
+            path_records[depth] = tree_result.node_ptr;
+        }
+    }
+
+    for(int i = 1; i <= my_puzzle->size; ++i) {
+        if(get_n_available_pieces(my_puzzle, i) != ckpt->free_pieces[i - 1]) {
+            printf("The free pieces of the checkpoint do not match.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    path_depth = ckpt->path_depth;
+    root_tile = ckpt->path[0].tile_type;
+    solver_rng = ckpt->rng;
+    loop_n = ckpt->n_iterations;
+    n_pruned_nodes = ckpt->n_pruned_nodes;
+    tt_hits = ckpt->tt_hits;
+    tt_misses = ckpt->tt_misses;
+    memcpy(prune_hits, ckpt->prune_hits, sizeof(prune_hits));
+    prior_cpu_time = ckpt->cpu_time;
+
+    if(print_full_log)
+        fprintf(log_fptr, "Resumed at depth %d after %" PRIu64
+                " iterations\n", path_depth, loop_n);
+}
+
+// Only called at the top of the search loop, where the board matches the
+// search path
+void save_checkpoint() {
+    checkpoint ckpt = {0};
+    ckpt.mode = CKPT_MODE_TREE;
+    ckpt.puzzle_type = my_puzzle->size;
+    ckpt.prune_rules = prune_rules;
+    ckpt.break_symmetry = symmetry_set;
+    ckpt.select_strategy = select_strategy;
+    ckpt.seed = seed;
+    ckpt.rng = solver_rng;
+    ckpt.n_iterations = loop_n;
+    ckpt.n_pruned_nodes = n_pruned_nodes;
+    ckpt.tt_hits = tt_hits;
+    ckpt.tt_misses = tt_misses;
+    memcpy(ckpt.prune_hits, prune_hits, sizeof(prune_hits));
+    ckpt.cpu_time =
+        prior_cpu_time + (double)(clock() - search_begin) / CLOCKS_PER_SEC;
+    for(int i = 1; i <= my_puzzle->size; ++i) {
+        ckpt.free_pieces[i - 1] = get_n_available_pieces(my_puzzle, i);
+    }
+    ckpt.path_depth = path_depth;
+    ckpt.path = search_path;
+
+    if(ckpt_write(checkpoint_path, &ckpt) && print_full_log)
+        fprintf(log_fptr, "Checkpoint at depth %d after %" PRIu64
+                " iterations\n", path_depth, loop_n);
+}
+
+// Places the path of an enumeration checkpoint on the empty board, the
+// last level may not have a tile placed yet
+void restore_enumeration(search_state* state, checkpoint const* ckpt) {
+    for(int depth = 0; depth <= ckpt->path_depth; ++depth) {
+        node_placement placement = ckpt->path[depth];
+        bool is_placed = placement.tile_type != 0;
+        if((!is_placed && depth < ckpt->path_depth) ||
+           (is_placed &&
+            place_block(my_puzzle, placement.tile_type, placement.x_pos,
+                        placement.y_pos) != SUCCESS)) {
+            printf("The checkpoint does not fit the puzzle.\n");
+            exit(EXIT_FAILURE);
+        }
+        state->path[depth] = placement;
+        state->level_solutions[depth] = ckpt->level_solutions[depth];
+    }
+
+    for(int i = 1; i <= my_puzzle->size; ++i) {
+        if(get_n_available_pieces(my_puzzle, i) != ckpt->free_pieces[i - 1]) {
+            printf("The free pieces of the checkpoint do not match.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    state->depth = ckpt->path_depth;
+    state->n_nodes = ckpt->n_iterations;
+    state->n_backtracks = ckpt->n_backtracks;
+    state->deepest_depth = ckpt->deepest_depth;
+    state->n_solutions = ckpt->n_solutions;
+    state->n_unique_solutions = ckpt->n_unique_solutions;
+    state->n_raw_solutions = ckpt->n_raw_solutions;
+    state->n_tt_hits = ckpt->tt_hits;
+    state->n_tt_misses = ckpt->tt_misses;
+    memcpy(state->n_prunes, ckpt->prune_hits, sizeof(state->n_prunes));
+    solver_rng = ckpt->rng;
+    prior_cpu_time = ckpt->cpu_time;
+
+    if(print_full_log)
+        fprintf(log_fptr, "Resumed at depth %d after %" PRIu64 " nodes\n",
+                state->depth, state->n_nodes);
+}
+
+// Only called at the top of the dfs loop, where the board matches the path
+void save_enumeration_checkpoint(search_state* state) {
+    checkpoint ckpt = {0};
+    ckpt.mode = CKPT_MODE_ENUMERATE;
+    ckpt.puzzle_type = my_puzzle->size;
+    ckpt.prune_rules = prune_rules;
+    ckpt.break_symmetry = symmetry_set;
+    // without --select the tiles are tried in ascending order
+    ckpt.select_strategy = select_set ? select_strategy : SELECT_SMALLEST;
+    ckpt.seed = seed;
+    ckpt.rng = solver_rng;
+    ckpt.n_iterations = state->n_nodes;
+    ckpt.tt_hits = state->n_tt_hits;
+    ckpt.tt_misses = state->n_tt_misses;
+    memcpy(ckpt.prune_hits, state->n_prunes, sizeof(ckpt.prune_hits));
+    ckpt.cpu_time =
+        prior_cpu_time + (double)(clock() - search_begin) / CLOCKS_PER_SEC;
+    ckpt.n_backtracks = state->n_backtracks;
+    ckpt.deepest_depth = state->deepest_depth;
+    ckpt.n_solutions = state->n_solutions;
+    ckpt.n_unique_solutions = state->n_unique_solutions;
+    ckpt.n_raw_solutions = state->n_raw_solutions;
+    for(int i = 1; i <= my_puzzle->size; ++i) {
+        ckpt.free_pieces[i - 1] = get_n_available_pieces(my_puzzle, i);
+    }
+    ckpt.path_depth = state->depth;
+    ckpt.path = state->path;
+    ckpt.level_solutions = state->level_solutions;
+
+    if(ckpt_write(checkpoint_path, &ckpt) && print_full_log)
+        fprintf(log_fptr, "Checkpoint at depth %d after %" PRIu64
+                " nodes\n", state->depth, state->n_nodes);
+}
+
+// Progress callback of an enumeration with --checkpoint. A due checkpoint
+// or a stop request cancels the search, which stops at the top of its
+// loop, where the path matches the board
+void check_enumeration_checkpoint(search_state* state, void* ctx) {
+    if(telemetry_set) {
+        publish_state_telemetry(state, ctx);
+    } else {
+        print_enumeration_progress(state, ctx);
+    }
+    if(stop_requested || wall_time_seconds() >= next_checkpoint_time) {
+        atomic_store(state->cancel, true);
+    }
+}
+
+// Runs the enumeration in stretches of checkpoint_interval seconds and
+// writes a checkpoint after each of them
+void run_checkpointed_enumeration(search_state* state) {
+    atomic_bool is_checkpoint_due;
+    atomic_init(&is_checkpoint_due, false);
+    state->cancel = &is_checkpoint_due;
+    state->progress_func = check_enumeration_checkpoint;
+    state->progress_ctx = "enumerate";
+
+    bool is_started = false;
+    if(resume_path) {
+        restore_enumeration(state, &resume_state);
+        is_started = true;
+    }
+    next_checkpoint_time = wall_time_seconds() + checkpoint_interval;
+    while(true) {
+        if(is_started) {
+            dfs_resume(state, 0);
+        } else {
+            dfs_run(state);
+            is_started = true;
+        }
+        if(!atomic_load(&is_checkpoint_due)) {
+            break;
+        }
+
+        save_enumeration_checkpoint(state);
+        if(stop_requested) {
+            is_interrupted = true;
+            break;
+        }
+        atomic_store(&is_checkpoint_due, false);
+        next_checkpoint_time = wall_time_seconds() + checkpoint_interval;
+    }
+    state->cancel = NULL;
+}
+
+void request_stop(int signum) {
+    (void)signum;
+    stop_requested = 1;
+}
+
 void set_visualizer(VIS_F_PTR grid_prep_func_in,
                     VIS_F_PTR grid_render_func_in,
                     VIS_F_PTR grid_reset_func_in,
@@ -136,159 +454,212 @@ void set_visualizer(VIS_F_PTR grid_prep_func_in,
 #endif
 }
 
-tree_node* record_placement(int selected_tile,
-                            int x_pos,
-                            int y_pos,
-                            tree_node* prev_placement) {
-    node_placement* node_buffer = malloc(node_size);
-    node_buffer->tile_type = selected_tile;
-    node_buffer->x_pos = x_pos;
-    node_buffer->y_pos = y_pos;
-    node_buffer->valid_tiles = 0xFFFF;
+// Redraws the grid with the placements of a path, called on the render
+// thread for every frame
+void draw_vis_frame(node_placement const* placements,
+                    int n_placements,
+                    void* ctx) {
+    int grid_size = *(int const*)ctx;
+
+    grid_prep_func(grid_size);
+    for(int i = 0; i < n_placements; ++i) {
+        block_set_func(placements[i].tile_type, placements[i].x_pos,
+                       placements[i].y_pos);
+    }
+    grid_render_func(grid_size);
+    grid_reset_func(grid_size);
+}
 
-    tree_node_add(&tree_result, &placement_record, prev_placement,
-                  NODE_PARTRIDGE, node_size, node_buffer);
-    free(node_buffer);
+// Pushes a placement onto the search path. A child of an unrecorded node is
+// not recorded either, so the kept tree is the top of the explored tree
+void record_placement(int selected_tile, int x_pos, int y_pos) {
+    tree_node* parent_record = path_records[path_depth];
+
+    node_placement* placement = &search_path[++path_depth];
+    deepest_depth = path_depth > deepest_depth ? path_depth : deepest_depth;
+    placement->tile_type = selected_tile;
+    placement->x_pos = x_pos;
+    placement->y_pos = y_pos;
+    placement->valid_tiles = 0xFFFF;
+
+    path_records[path_depth] = NULL;
+    if(parent_record && placement_record.tree_size < tree_cap) {
+        tree_node_add(&tree_result, &placement_record, parent_record,
+                      NODE_PARTRIDGE, node_size, placement);
+        path_records[path_depth] = tree_result.node_ptr;
+    }
+}
 
-    // visualize placement
-    if(visualizer_set) {
-        block_set_func(selected_tile, x_pos, y_pos);
-        grid_render_func(my_puzzle->grid_dimension);
-        grid_reset_func(my_puzzle->grid_dimension);
+// Sets the tiles left to try on top of the search path
+uint16_t set_valid_tiles(uint16_t valid_tiles) {
+    search_path[path_depth].valid_tiles = valid_tiles;
+    if(path_records[path_depth]) {
+        node_placement* record_data =
+            (node_placement*)path_records[path_depth]->data;
+        record_data->valid_tiles = valid_tiles;
     }
 
-    return tree_result.node_ptr;
+    return valid_tiles;
 }
 
-uint16_t record_removal(int selected_tile,
-                        int x_pos,
-                        int y_pos,
-                        tree_node* parent) {
-    node_placement* parent_placement_data = (node_placement*)parent->data;
-
-    parent_placement_data->valid_tiles &= ~(1 << (selected_tile - 1));
+// Pops the last placement off the search path and marks its tile as tried
+// on the placement below
+uint16_t record_removal() {
+    node_placement removed = search_path[path_depth--];
+    ++n_backtracks;
 
-    // visualize removal
-    if(visualizer_set) {
-        block_remove_func(selected_tile, x_pos, y_pos);
-        grid_render_func(my_puzzle->grid_dimension);
-        grid_reset_func(my_puzzle->grid_dimension);
-    }
+    uint16_t valid_tiles = set_valid_tiles(
+        search_path[path_depth].valid_tiles & ~(1 << (removed.tile_type - 1)));
 
-    return parent_placement_data->valid_tiles;
+    return valid_tiles;
 }
 
 bool solution_search() {
-    int puzzle_type = my_puzzle->size;
-
-    is_solvable = is_solvable_gap_cond(my_puzzle);
+    is_solvable = check_prune_rules(my_puzzle, prune_rules) == NO_PRUNE;
     is_solved = is_puzzle_solved(my_puzzle);
 
     uint16_t valid_tiles_buffer = 0xFFFF;
 
     point result_buffer = {0};
-    loop_n = 0;
+    double next_checkpoint = wall_time_seconds() + checkpoint_interval;
     while(!is_solved) {
+        if(checkpoint_path && stop_requested) {
+            save_checkpoint();
+            is_interrupted = true;
+            break;
+        }
+        if(checkpoint_path && loop_n % CHECKPOINT_CHECK_PERIOD == 0 &&
+           wall_time_seconds() >= next_checkpoint) {
+            save_checkpoint();
+            next_checkpoint = wall_time_seconds() + checkpoint_interval;
+        }
+        if(telemetry_set && loop_n % TELEM_CHECK_PERIOD == 0 &&
+           telem_is_due(&telemetry)) {
+            publish_search_telemetry();
+        }
+        if(visualizer_set && frame_is_due(&vis_frames)) {
+            frame_publish(&vis_frames, search_path, path_depth + 1);
+        }
+
         if(++loop_n % 100000 == 0 && !visualizer_set) {
-            printf("Current iter.: %d - Tree Size: %zu Nodes", loop_n,
-                   placement_record.tree_size);
+            printf("Current iter.: %" PRIu64 " - Depth: %2d - Tree Size: %zu "
+                   "Nodes",
+                   loop_n, path_depth, placement_record.tree_size);
             fflush(stdout);
             printf("\r");
         }
 
         line_scan_hor(my_puzzle, &result_buffer);
 
-        node_placement* placement_data = (node_placement*)last_placement->data;
-        placement_data->valid_tiles =
-            set_exhausted_tiles(placement_data->valid_tiles);
+        // tiles larger than the free square at the cell never fit and are
+        // dropped before the selection
+        node_placement* placement_data = &search_path[path_depth];
+        set_valid_tiles(set_exhausted_tiles(placement_data->valid_tiles) &
+                        FIT_TILES(get_max_fit(my_puzzle,
+                                              result_buffer.x_index,
+                                              result_buffer.y_index)));
+        valid_tiles_buffer = placement_data->valid_tiles;
 
         // select one tile and place
         RETURN_CODES placement_code = -1;
-        do {
-            int selected_tile =
-                random_tile_select(placement_data->valid_tiles, puzzle_type);
+        while(placement_code != SUCCESS && valid_tiles_buffer != 0) {
+            int selected_tile = tile_select(
+                my_puzzle, placement_data->valid_tiles, &solver_rng);
             if(print_full_log)
                 fprintf(log_fptr, "Current tile: %d", selected_tile);
 
-            placement_code =
-                place_block(my_puzzle, selected_tile, result_buffer.x_index,
-                            result_buffer.y_index);
+            if(symmetry_set &&
+               !is_symmetry_allowed(my_puzzle, selected_tile,
+                                    result_buffer.x_index,
+                                    result_buffer.y_index)) {
+                placement_code = CONFLICT_ON_GRID;
+            } else {
+                placement_code = place_block(my_puzzle, selected_tile,
+                                             result_buffer.x_index,
+                                             result_buffer.y_index);
+            }
 
             if(placement_code == SUCCESS) {
                 if(print_full_log)
                     fprintf(log_fptr, " - Placement success: true\n");
 
-                last_placement =
-                    record_placement(selected_tile, result_buffer.x_index,
-                                     result_buffer.y_index, last_placement);
+                record_placement(selected_tile, result_buffer.x_index,
+                                 result_buffer.y_index);
             } else {
-                placement_data->valid_tiles &= ~(1 << (selected_tile - 1));
+                set_valid_tiles(placement_data->valid_tiles &
+                                ~(1 << (selected_tile - 1)));
 
                 if(print_full_log)
                     fprintf(log_fptr, " - Placement success: false\n");
             }
 
             valid_tiles_buffer = placement_data->valid_tiles;
-        } while(placement_code != SUCCESS &&
-                n_ok_tile_types(valid_tiles_buffer) > 0);
+        }
 
-        is_solvable = is_solvable_gap_cond(my_puzzle);
+        PRUNE_RULE prune_rule = check_prune_rules(my_puzzle, prune_rules);
+        ++prune_hits[prune_rule];
+        is_solvable = prune_rule == NO_PRUNE;
+        if(is_solvable && tt_size_mb > 0 && placement_code == SUCCESS) {
+            if(tt_probe(&transposition_table,
+                        tt_state_key(my_puzzle, symmetry_set))) {
+                ++tt_hits;
+                is_solvable = false;
+            } else {
+                ++tt_misses;
+            }
+        }
         if(!is_solvable) {
-            tree_node* parent = last_placement->parent;
-            node_placement cur_placement_data =
-                *(node_placement*)last_placement->data;
+            node_placement cur_placement_data = search_path[path_depth];
 
             remove_block(my_puzzle, cur_placement_data.tile_type,
                          cur_placement_data.x_pos, cur_placement_data.y_pos);
 
-            valid_tiles_buffer = record_removal(
-                cur_placement_data.tile_type, cur_placement_data.x_pos,
-                cur_placement_data.y_pos, parent);
+            valid_tiles_buffer = record_removal();
 
             if(print_full_log)
                 fprintf(log_fptr, " Remove tile: %d, Pos. (%2d,%2d)\n",
                         cur_placement_data.tile_type, cur_placement_data.x_pos,
                         cur_placement_data.y_pos);
-
-            last_placement = parent;
         }
 
         while(n_ok_tile_types(valid_tiles_buffer) == 0) {
-            tree_node* parent = last_placement->parent;
-            node_placement cur_placement_data =
-                *(node_placement*)last_placement->data;
+            node_placement cur_placement_data = search_path[path_depth];
+
+            // every tile has been tried on this board
+            if(tt_size_mb > 0) {
+                tt_store(&transposition_table,
+                         tt_state_key(my_puzzle, symmetry_set),
+                         tt_remaining_pieces(my_puzzle));
+            }
 
             remove_block(my_puzzle, cur_placement_data.tile_type,
                          cur_placement_data.x_pos, cur_placement_data.y_pos);
 
-            if(last_placement == placement_record.tree_root) {
+            if(path_depth == 0) {
                 if(print_full_log)
                     fprintf(log_fptr,
                             " Remove tile: %d, Pos. (%2d,%2d) - Root\n\n",
                             cur_placement_data.tile_type,
                             cur_placement_data.x_pos, cur_placement_data.y_pos);
 
-                if(visualizer_set) {
-                    block_remove_func(cur_placement_data.tile_type,
-                                      cur_placement_data.x_pos,
-                                      cur_placement_data.y_pos);
-                    grid_render_func(my_puzzle->grid_dimension);
-                    grid_reset_func(my_puzzle->grid_dimension);
-                }
-
                 goto finish;
             }
 
-            valid_tiles_buffer = record_removal(
-                cur_placement_data.tile_type, cur_placement_data.x_pos,
-                cur_placement_data.y_pos, parent);
+            // nothing below an exhausted placement is searched again
+            if(!fulltree_set && path_records[path_depth]) {
+                size_t tree_size = placement_record.tree_size;
+                tree_prune(&tree_result, &placement_record,
+                           path_records[path_depth]);
+                n_pruned_nodes += tree_size - placement_record.tree_size;
+                path_records[path_depth] = NULL;
+            }
+
+            valid_tiles_buffer = record_removal();
 
             if(print_full_log)
                 fprintf(log_fptr, " Remove tile: %d, Pos. (%2d,%2d)\n",
                         cur_placement_data.tile_type, cur_placement_data.x_pos,
                         cur_placement_data.y_pos);
-
-            last_placement = parent;
         }
 
         is_solved = is_puzzle_solved(my_puzzle);
@@ -301,9 +672,130 @@ finish:
 int main(int argc, char* argv[]) {
     print_full_log = false;
     visualizer_set = false;
+    enumerate_set = false;
+    n_threads = 0;
+    prune_rules = DEFAULT_PRUNE_RULES;
+    symmetry_set = false;
+    dlx_set = false;
+    tt_size_mb = 0;
+    tt_policy = TT_REPLACE_LARGER;
+    seed_set = false;
+    restart_strategy = RESTART_NONE;
+    restart_base = RESTART_DEFAULT_BASE;
+    stats_path = NULL;
+    stack_set = false;
+    fulltree_set = false;
+    tree_cap_set = false;
+    tree_cap = SIZE_MAX;
+    checkpoint_path = NULL;
+    resume_path = NULL;
+    checkpoint_interval = CHECKPOINT_DEFAULT_INTERVAL;
+    vis_fps = FRAME_DEFAULT_FPS;
+    telemetry_path = NULL;
+    telemetry_socket = NULL;
+    telemetry_interval = TELEM_DEFAULT_INTERVAL;
+    telemetry_set = false;
+    solutions_path = NULL;
+    select_strategy = SELECT_RANDOM;
+    select_set = false;
     int puzzle_type = 8;
 
     handle_input(argc, argv, &puzzle_type);
+    if(resume_path) {
+        if(!ckpt_read(resume_path, &resume_state)) {
+            printf("Could not read the checkpoint %s\n", resume_path);
+            exit(EXIT_FAILURE);
+        }
+        // the run continues with the settings it was started with
+        enumerate_set = resume_state.mode == CKPT_MODE_ENUMERATE;
+        select_set = select_set || enumerate_set;
+        puzzle_type = resume_state.puzzle_type;
+        prune_rules = resume_state.prune_rules;
+        symmetry_set = resume_state.break_symmetry;
+        select_strategy = (SELECT_STRATEGY)resume_state.select_strategy;
+        seed = resume_state.seed;
+        seed_set = true;
+        if(!checkpoint_path) {
+            checkpoint_path = resume_path;
+        }
+        printf("Resuming from %s\n", resume_path);
+    }
+    if(stack_set && !tree_cap_set) {
+        tree_cap = 0;
+    }
+    if(!seed_set) {
+        seed = (uint64_t)time(NULL);
+    }
+    rng_seed(&solver_rng, seed);
+    tile_select = sel_func(select_strategy);
+
+    if(restart_strategy != RESTART_NONE && (enumerate_set || dlx_set)) {
+        printf(
+            "Restarts are only available for the first solution search of "
+            "the default engine.\n");
+        restart_strategy = RESTART_NONE;
+    }
+    if(restart_strategy != RESTART_NONE && n_threads > 0) {
+        printf("Restarts run single threaded, --threads is ignored.\n");
+        n_threads = 0;
+    }
+    if(dlx_set && n_threads > 0) {
+        printf("The dlx engine runs single threaded, --threads is ignored.\n");
+        n_threads = 0;
+    }
+    if(dlx_set && symmetry_set) {
+        printf("Symmetry breaking is not available for the dlx engine.\n");
+        symmetry_set = false;
+    }
+    if(dlx_set && select_set) {
+        printf("The dlx engine picks its own placements, --select is "
+               "ignored.\n");
+        select_set = false;
+    }
+    if(select_set && select_strategy != SELECT_RANDOM &&
+       restart_strategy != RESTART_NONE) {
+        printf("Every restart repeats the same search unless --select is "
+               "random.\n");
+    }
+    if(select_set && select_strategy == SELECT_RANDOM && n_threads > 0) {
+        printf("The random tile order is not available with --threads.\n");
+        select_set = false;
+    }
+    if(dlx_set && tt_size_mb > 0) {
+        printf("The transposition table is not used by the dlx engine.\n");
+        tt_size_mb = 0;
+    }
+    if(tt_size_mb > 0) {
+        tt_init(&transposition_table, tt_size_mb, tt_policy);
+    }
+    bool is_path_search = enumerate_set || n_threads > 0 || dlx_set ||
+                          restart_strategy != RESTART_NONE;
+    if(is_path_search && visualizer_set) {
+        printf(
+            "The visualizer is not available in enumeration, parallel, dlx "
+            "or restart mode.\n");
+        visualizer_set = false;
+    }
+    bool is_checkpoint_search =
+        !is_path_search || (enumerate_set && n_threads == 0 && !dlx_set);
+    if(!is_checkpoint_search && (checkpoint_path || resume_path)) {
+        printf(
+            "Checkpoints are only available for the first solution search "
+            "and the single threaded enumeration of the default engine.\n");
+        checkpoint_path = NULL;
+        resume_path = NULL;
+    }
+    if(enumerate_set && resume_path && solutions_path) {
+        printf("A solution stream cannot be continued, --solutions is "
+               "ignored with --resume.\n");
+        solutions_path = NULL;
+    }
+
+    if((telemetry_path || telemetry_socket) && n_threads > 0) {
+        printf("Telemetry is not available with --threads.\n");
+        telemetry_path = NULL;
+        telemetry_socket = NULL;
+    }
 
     // Make logs dir
     struct stat st = {0};
@@ -318,46 +810,104 @@ int main(int argc, char* argv[]) {
     // Open a file in writing mode
     log_fptr = fopen("logs/log.txt", "w");
     tree_fptr = fopen("logs/tree.txt", "w");
+    if(solutions_path && !stream_open(&solution_stream, solutions_path,
+                                      puzzle_type)) {
+        exit(EXIT_FAILURE);
+    }
+    if(telemetry_path || telemetry_socket) {
+        if(!telem_open(&telemetry, telemetry_path, telemetry_socket,
+                       telemetry_interval)) {
+            exit(EXIT_FAILURE);
+        }
+        telemetry_set = true;
+    }
+
+    if(checkpoint_path) {
+        signal(SIGINT, request_stop);
+        signal(SIGTERM, request_stop);
+    }
+
+    if(is_path_search) {
+        if(enumerate_set) {
+            run_enumeration(puzzle_type);
+        } else {
+            run_first_search(puzzle_type);
+        }
+        ckpt_free(&resume_state);
+        if(solutions_path) {
+            stream_close(&solution_stream);
+        }
+        if(telemetry_set) {
+            telem_close(&telemetry);
+        }
+
+        fclose(log_fptr);
+        fclose(tree_fptr);
+        tt_free(&transposition_table);
+        return EXIT_SUCCESS;
+    }
 
     setup(puzzle_type);
+    if(resume_path) {
+        ckpt_free(&resume_state);
+    }
 
     if(visualizer_set) {
-        set_visualizer(prep_vis_grid, render_vis_grid, reset_vis_grid,
-                       record_vis_grid, set_vis_block, remove_vis_block,
-                       def_block_colors);
+        set_visualizer(prep_vis_frame, render_vis_frame, reset_vis_frame,
+                       record_vis_grid, set_vis_frame_block,
+                       remove_vis_frame_block, def_block_colors);
         COLOR blocks[] = {WHITE,     ROYAL_BLUE, ORANGE, MAGENTA,
                           CYAN,      RED,        GREEN,  GRAY,
                           DARKGRAY,  YELLOW,     BLUE,   HINGREEN,
                           HINYELLOW, HINBLUE,    PINK,   LIGRAY};
         block_set_color_func((int*)blocks, my_puzzle->size);
-        grid_prep_func(my_puzzle->grid_dimension);
 
-        // record root tile
-        block_set_func(root_tile, 0, 0);
-        grid_render_func(my_puzzle->grid_dimension);
-        grid_reset_func(my_puzzle->grid_dimension);
-#ifdef _WIN32
-        Sleep(0.5);
-#else
-        usleep(5 * 10000);
-#endif
+        // the root tile and the rest of a resumed path are the first frame
+        frame_init(&vis_frames, dfs_max_depth(puzzle_type) + 1, vis_fps,
+                   draw_vis_frame, &my_puzzle->grid_dimension);
+        draw_vis_frame(search_path, path_depth + 1,
+                       &my_puzzle->grid_dimension);
+        if(!frame_start(&vis_frames)) {
+            printf("The visualizer thread could not be started.\n");
+            frame_free(&vis_frames);
+            visualizer_set = false;
+        }
     }
 
-    clock_t begin = clock();
+    search_begin = clock();
+    double begin_wall = wall_time_seconds();
 
     is_solvable = solution_search();
+    if(telemetry_set) {
+        publish_search_telemetry();
+        telem_close(&telemetry);
+    }
 
     clock_t end = clock();
-    double solve_time = (double)(end - begin) / CLOCKS_PER_SEC;
+    double solve_time =
+        prior_cpu_time + (double)(end - search_begin) / CLOCKS_PER_SEC;
+    double wall_time = wall_time_seconds() - begin_wall;
 
+    if(visualizer_set) {
+        frame_free(&vis_frames);
+    }
     if(is_solved && visualizer_set) {
+        draw_vis_frame(search_path, path_depth + 1,
+                       &my_puzzle->grid_dimension);
         grid_record_func(my_puzzle->grid_dimension);
     }
 
-    fprintf(log_fptr, "Puzzle Status: Solvable: %s - Solved: %s\n\n",
-            is_solvable ? "true" : "false", is_solved ? "true" : "false");
-    printf("Puzzle Status: Solvable: %s - Solved: %s\n",
-           is_solvable ? "true" : "false", is_solved ? "true" : "false");
+    if(is_interrupted) {
+        fprintf(log_fptr, "Puzzle Status: Interrupted - Checkpoint: %s\n\n",
+                checkpoint_path);
+        printf("Puzzle Status: Interrupted - Checkpoint: %s\n",
+               checkpoint_path);
+    } else {
+        fprintf(log_fptr, "Puzzle Status: Solvable: %s - Solved: %s\n\n",
+                is_solvable ? "true" : "false", is_solved ? "true" : "false");
+        printf("Puzzle Status: Solvable: %s - Solved: %s\n",
+               is_solvable ? "true" : "false", is_solved ? "true" : "false");
+    }
     printf("\33[2K\r\n");
 
     print_grid(my_puzzle, NULL);
@@ -371,44 +921,529 @@ int main(int argc, char* argv[]) {
     fprintf(tree_fptr, "Tree Size: %zu Nodes\n", placement_record.tree_size);
     fprintf(log_fptr, "\nTree Size: %zu Nodes\n", placement_record.tree_size);
 
-    printf("n-Iterations: %d\n", loop_n);
-    fprintf(log_fptr, "n-Iterations: %d\n", loop_n);
+    if(!fulltree_set) {
+        printf("Pruned: %" PRIu64 " Nodes\n", n_pruned_nodes);
+        fprintf(log_fptr, "Pruned: %" PRIu64 " Nodes\n", n_pruned_nodes);
+    }
+    if(tree_cap_set || stack_set) {
+        printf("Tree Cap: %zu Nodes\n", tree_cap);
+        fprintf(log_fptr, "Tree Cap: %zu Nodes\n", tree_cap);
+    }
+
+    printf("n-Iterations: %" PRIu64 "\n", loop_n);
+    fprintf(log_fptr, "n-Iterations: %" PRIu64 "\n", loop_n);
+    printf("Seed: %" PRIu64 "\n", seed);
+    fprintf(log_fptr, "Seed: %" PRIu64 "\n", seed);
+    print_prune_hits(prune_hits, stdout);
+    print_prune_hits(prune_hits, log_fptr);
+    print_tt_stats(tt_hits, tt_misses, stdout);
+    print_tt_stats(tt_hits, tt_misses, log_fptr);
     printf("Solve Time: %f seconds\n", solve_time);
     fprintf(log_fptr, "Solve Time: %f seconds\n", solve_time);
 
-    bool* flags = malloc(sizeof(bool) * placement_record.tree_size);
-    memset(flags, true, placement_record.tree_size);
-
-    if(placement_record.tree_size <= 100000) {
+    run_stats stats = {0};
+    stats.mode = "tree";
+    stats.puzzle_type = puzzle_type;
+    stats.is_solved = is_solved;
+    stats.n_nodes = loop_n;
+    stats.n_solutions = is_solved ? 1 : 0;
+    stats.tree_size = placement_record.tree_size;
+    stats.wall_time = wall_time;
+    stats.cpu_time = solve_time;
+    write_run_stats(&stats);
+
+    if(placement_record.tree_root && placement_record.tree_size <= 100000) {
+        bool* flags = malloc(sizeof(bool) * placement_record.tree_size);
+        memset(flags, true, placement_record.tree_size);
         printTree(placement_record.tree_root, 0, false, flags, tree_fptr);
+        free(flags);
     } else if(is_solved) {
         printWinningBranch(tree_fptr);
     }
+    if(solutions_path) {
+        if(is_solved) {
+            stream_write(&solution_stream, search_path);
+        }
+        stream_close(&solution_stream);
+    }
+    tree_free(&tree_result, &placement_record);
+    arena_free(&placement_arena);
 
     // Close the files
     fclose(log_fptr);
     fclose(tree_fptr);
+    tt_free(&transposition_table);
 
     return EXIT_SUCCESS;
 }
 
-bool line_scan_hor(puzzle_def* puzzle, point* result) {
-    int** grid = puzzle->puzzle_grid;
-    for(int i = 0; i < puzzle->grid_dimension; ++i) {
-        for(int j = 0; j < puzzle->grid_dimension; ++j) {
-            if(grid[i][j] == 0) {
-                result->x_index = j;
-                result->y_index = i;
-                return true;
+// Exhaustive search from the empty board, every tiling is counted once.
+// Only the current path is held in memory, see dfs.h
+void run_enumeration(int puzzle_type) {
+    my_puzzle = calloc(1, sizeof(puzzle_def));
+    my_puzzle->size = puzzle_type;
+    init_puzzle(my_puzzle);
+
+    search_state state = {0};
+    dfs_init(&state, my_puzzle, SEARCH_COUNT);
+    state.prune_rules = prune_rules;
+    state.break_symmetry = symmetry_set;
+    state.tt = tt_size_mb > 0 ? &transposition_table : NULL;
+    if(select_set) {
+        state.select_func = tile_select;
+        state.select_ctx = &solver_rng;
+    }
+    state.progress_func = print_enumeration_progress;
+    if(telemetry_set) {
+        state.progress_func = publish_state_telemetry;
+        state.progress_ctx = "enumerate";
+    }
+    if(print_full_log || solutions_path)
+        state.solution_func = record_solution;
+
+    par_settings settings = {0};
+    settings.n_threads = n_threads;
+    settings.mode = SEARCH_COUNT;
+    settings.prune_rules = prune_rules;
+    settings.break_symmetry = symmetry_set;
+    settings.tt = state.tt;
+    settings.select_func = state.select_func;
+    settings.select_ctx = state.select_ctx;
+    settings.solution_func = state.solution_func;
+
+    double begin = wall_time_seconds();
+    clock_t begin_cpu = clock();
+    search_begin = begin_cpu;
+
+    if(n_threads > 0) {
+        par_search(my_puzzle, &settings);
+        state.n_nodes = settings.n_nodes;
+        state.n_solutions = settings.n_solutions;
+        state.n_unique_solutions = settings.n_unique_solutions;
+        state.n_raw_solutions = settings.n_raw_solutions;
+        memcpy(state.n_prunes, settings.n_prunes, sizeof(state.n_prunes));
+        state.n_tt_hits = settings.n_tt_hits;
+        state.n_tt_misses = settings.n_tt_misses;
+    } else if(dlx_set) {
+        dlx_run(&state);
+    } else if(checkpoint_path) {
+        run_checkpointed_enumeration(&state);
+    } else {
+        dfs_run(&state);
+    }
+
+    // a resumed run continues the counters, the rate is the one of this run
+    uint64_t n_resumed_nodes = resume_path ? resume_state.n_iterations : 0;
+    double solve_time = wall_time_seconds() - begin;
+    double cpu_time =
+        prior_cpu_time + (double)(clock() - begin_cpu) / CLOCKS_PER_SEC;
+    double nodes_per_sec =
+        solve_time > 0 ? (state.n_nodes - n_resumed_nodes) / solve_time : 0;
+
+    printf("\33[2K\r");
+    printf("Enumeration: Puzzle type %d\n", puzzle_type);
+    fprintf(log_fptr, "Enumeration: Puzzle type %d\n", puzzle_type);
+    if(is_interrupted) {
+        printf("Enumeration: Interrupted - Checkpoint: %s\n",
+               checkpoint_path);
+        fprintf(log_fptr, "Enumeration: Interrupted - Checkpoint: %s\n",
+                checkpoint_path);
+    }
+    if(n_threads > 0) {
+        printf("Threads: %d - Tasks: %zu\n", n_threads, settings.n_tasks);
+        fprintf(log_fptr, "Threads: %d - Tasks: %zu\n", n_threads,
+                settings.n_tasks);
+    }
+
+    if(symmetry_set) {
+        printf("Explored Solutions: %" PRIu64 "\n", state.n_solutions);
+        fprintf(log_fptr, "Explored Solutions: %" PRIu64 "\n",
+                state.n_solutions);
+    }
+    printf("Total Solutions: %" PRIu64 "\n", state.n_raw_solutions);
+    printf("Unique Solutions: %" PRIu64 "\n", state.n_unique_solutions);
+    printf("Nodes: %" PRIu64 "\n", state.n_nodes);
+    printf("Nodes/sec: %.0f\n", nodes_per_sec);
+    printf("Wall Time: %f seconds\n", solve_time);
+    printf("CPU Time: %f seconds\n", cpu_time);
+
+    fprintf(log_fptr, "Total Solutions: %" PRIu64 "\n",
+            state.n_raw_solutions);
+    fprintf(log_fptr, "Unique Solutions: %" PRIu64 "\n",
+            state.n_unique_solutions);
+    fprintf(log_fptr, "Nodes: %" PRIu64 "\n", state.n_nodes);
+    fprintf(log_fptr, "Nodes/sec: %.0f\n", nodes_per_sec);
+    fprintf(log_fptr, "Wall Time: %f seconds\n", solve_time);
+    fprintf(log_fptr, "CPU Time: %f seconds\n", cpu_time);
+
+    print_prune_hits(state.n_prunes, stdout);
+    print_prune_hits(state.n_prunes, log_fptr);
+    print_tt_stats(state.n_tt_hits, state.n_tt_misses, stdout);
+    print_tt_stats(state.n_tt_hits, state.n_tt_misses, log_fptr);
+
+    run_stats stats = {0};
+    stats.mode = "enumerate";
+    stats.puzzle_type = puzzle_type;
+    stats.is_solved = state.n_solutions > 0;
+    stats.n_nodes = state.n_nodes;
+    stats.n_solutions = state.n_raw_solutions;
+    stats.wall_time = solve_time;
+    stats.cpu_time = cpu_time;
+    write_run_stats(&stats);
+
+    dfs_free(&state);
+}
+
+// Runs the first solution search with a random tile order until the node
+// budget of the current restart runs out, then starts over from the empty
+// board. Dead boards in the transposition table are kept across restarts.
+// Returns the number of restarts
+int run_restarts(search_state* state) {
+    int restart = 1;
+    while(true) {
+        uint64_t budget =
+            restart_budget(restart_strategy, restart_base, restart);
+        state->node_limit = state->n_nodes + budget;
+        if(print_full_log)
+            fprintf(log_fptr, "Restart %d: budget %" PRIu64 " nodes\n",
+                    restart, budget);
+
+        // an exhausted search space ends the restarts as well
+        if(dfs_run(state) || state->n_nodes < state->node_limit) {
+            break;
+        }
+
+        dfs_unwind(state, 0);
+        ++restart;
+    }
+
+    return restart - 1;
+}
+
+// First solution search with the dlx engine, with restarts or on
+// n_threads workers, where the first worker to find a solution cancels
+// the others
+void run_first_search(int puzzle_type) {
+    my_puzzle = calloc(1, sizeof(puzzle_def));
+    my_puzzle->size = puzzle_type;
+    init_puzzle(my_puzzle);
+
+    par_settings settings = {0};
+    settings.n_threads = n_threads;
+    settings.mode = SEARCH_FIRST;
+    settings.prune_rules = prune_rules;
+    settings.break_symmetry = symmetry_set;
+    settings.tt = tt_size_mb > 0 ? &transposition_table : NULL;
+    if(select_set) {
+        settings.select_func = tile_select;
+        settings.select_ctx = &solver_rng;
+    }
+    if(print_full_log || solutions_path)
+        settings.solution_func = record_solution;
+
+    double begin = wall_time_seconds();
+    clock_t begin_cpu = clock();
+
+    int n_restarts = 0;
+    if(dlx_set) {
+        search_state state = {0};
+        dfs_init(&state, my_puzzle, SEARCH_FIRST);
+        state.prune_rules = prune_rules;
+        state.solution_func = settings.solution_func;
+        if(telemetry_set) {
+            state.progress_func = publish_state_telemetry;
+            state.progress_ctx = "dlx";
+        }
+        dlx_run(&state);
+        settings.n_nodes = state.n_nodes;
+        memcpy(settings.n_prunes, state.n_prunes, sizeof(state.n_prunes));
+        dfs_free(&state);
+    } else if(restart_strategy != RESTART_NONE) {
+        search_state state = {0};
+        dfs_init(&state, my_puzzle, SEARCH_FIRST);
+        state.prune_rules = prune_rules;
+        state.break_symmetry = symmetry_set;
+        state.tt = settings.tt;
+        // restarts only differ with a random tile order
+        state.select_func = select_set ? tile_select : sel_random;
+        state.select_ctx = &solver_rng;
+        state.solution_func = settings.solution_func;
+        if(telemetry_set) {
+            state.progress_func = publish_state_telemetry;
+            state.progress_ctx = "restart";
+        }
+        n_restarts = run_restarts(&state);
+        settings.n_nodes = state.n_nodes;
+        memcpy(settings.n_prunes, state.n_prunes, sizeof(state.n_prunes));
+        settings.n_tt_hits = state.n_tt_hits;
+        settings.n_tt_misses = state.n_tt_misses;
+        dfs_free(&state);
+    } else {
+        par_search(my_puzzle, &settings);
+    }
+
+    double solve_time = wall_time_seconds() - begin;
+    double cpu_time = (double)(clock() - begin_cpu) / CLOCKS_PER_SEC;
+    double nodes_per_sec = solve_time > 0 ? settings.n_nodes / solve_time : 0;
+
+    is_solved = is_puzzle_solved(my_puzzle);
+    fprintf(log_fptr, "Puzzle Status: Solved: %s\n\n",
+            is_solved ? "true" : "false");
+    printf("Puzzle Status: Solved: %s\n", is_solved ? "true" : "false");
+    printf("\33[2K\r\n");
+
+    print_grid(my_puzzle, NULL);
+    printf("\n");
+    print_free_pieces(my_puzzle, NULL);
+    print_grid(my_puzzle, log_fptr);
+    fprintf(log_fptr, "\n");
+    print_free_pieces(my_puzzle, log_fptr);
+
+    printf("\n");
+    fprintf(log_fptr, "\n");
+    if(n_threads > 0) {
+        printf("Threads: %d - Tasks: %zu\n", n_threads, settings.n_tasks);
+        fprintf(log_fptr, "Threads: %d - Tasks: %zu\n", n_threads,
+                settings.n_tasks);
+    }
+    if(restart_strategy != RESTART_NONE) {
+        printf("Restarts: %d - Strategy: %s - Base: %" PRIu64 "\n",
+               n_restarts, restart_strategy_name(restart_strategy),
+               restart_base);
+        fprintf(log_fptr, "Restarts: %d - Strategy: %s - Base: %" PRIu64 "\n",
+                n_restarts, restart_strategy_name(restart_strategy),
+                restart_base);
+        printf("Seed: %" PRIu64 "\n", seed);
+        fprintf(log_fptr, "Seed: %" PRIu64 "\n", seed);
+    }
+    printf("Nodes: %" PRIu64 "\n", settings.n_nodes);
+    fprintf(log_fptr, "Nodes: %" PRIu64 "\n", settings.n_nodes);
+    printf("Nodes/sec: %.0f\n", nodes_per_sec);
+    fprintf(log_fptr, "Nodes/sec: %.0f\n", nodes_per_sec);
+    printf("Solve Time: %f seconds\n", solve_time);
+    fprintf(log_fptr, "Solve Time: %f seconds\n", solve_time);
+    printf("CPU Time: %f seconds\n", cpu_time);
+    fprintf(log_fptr, "CPU Time: %f seconds\n", cpu_time);
+    print_prune_hits(settings.n_prunes, stdout);
+    print_prune_hits(settings.n_prunes, log_fptr);
+    print_tt_stats(settings.n_tt_hits, settings.n_tt_misses, stdout);
+    print_tt_stats(settings.n_tt_hits, settings.n_tt_misses, log_fptr);
+
+    run_stats stats = {0};
+    stats.mode = "parallel";
+    if(dlx_set) {
+        stats.mode = "dlx";
+    } else if(restart_strategy != RESTART_NONE) {
+        stats.mode = "restart";
+    }
+    stats.puzzle_type = puzzle_type;
+    stats.is_solved = is_solved;
+    stats.n_nodes = settings.n_nodes;
+    stats.n_solutions = is_solved ? 1 : 0;
+    stats.wall_time = solve_time;
+    stats.cpu_time = cpu_time;
+    write_run_stats(&stats);
+}
+
+// One "key value" pair per line, read back by the bench harness
+void write_run_stats(run_stats const* stats) {
+    if(!stats_path) {
+        return;
+    }
+
+    FILE* stats_fptr = fopen(stats_path, "w");
+    if(!stats_fptr) {
+        perror("fopen failed");
+        return;
+    }
+    fprintf(stats_fptr, "mode %s\n", stats->mode);
+    fprintf(stats_fptr, "size %d\n", stats->puzzle_type);
+    fprintf(stats_fptr, "seed %" PRIu64 "\n", seed);
+    fprintf(stats_fptr, "solved %d\n", stats->is_solved ? 1 : 0);
+    fprintf(stats_fptr, "nodes %" PRIu64 "\n", stats->n_nodes);
+    fprintf(stats_fptr, "solutions %" PRIu64 "\n", stats->n_solutions);
+    fprintf(stats_fptr, "tree_size %zu\n", stats->tree_size);
+    fprintf(stats_fptr, "wall_time %f\n", stats->wall_time);
+    fprintf(stats_fptr, "cpu_time %f\n", stats->cpu_time);
+    fclose(stats_fptr);
+}
+
+// Streams a solution to the log as its list of placements
+void log_enumerated_solution(search_state* state, void* ctx) {
+    fprintf(log_fptr, "Solution %" PRIu64 ":", state->n_solutions);
+    for(int i = 0; i <= state->depth; ++i) {
+        node_placement* level = &state->path[i];
+        fprintf(log_fptr, " %d@(%d,%d)", level->tile_type, level->x_pos,
+                level->y_pos);
+    }
+    fprintf(log_fptr, "\n");
+}
+
+// Called for every tiling found by the dfs, dlx and parallel searches
+void record_solution(search_state* state, void* ctx) {
+    if(print_full_log)
+        log_enumerated_solution(state, ctx);
+    if(solutions_path)
+        stream_write(&solution_stream, state->path);
+}
+
+void print_enumeration_progress(search_state* state, void* ctx) {
+    printf("Current nodes: %" PRIu64 " - Solutions: %" PRIu64
+           " - Depth: %d",
+           state->n_nodes, state->n_solutions, state->depth);
+    fflush(stdout);
+    printf("\r");
+}
+
+// Counters of the classic search, the iterations stand in for the nodes
+void publish_search_telemetry() {
+    telem_snapshot snapshot = {0};
+    snapshot.mode = "tree";
+    snapshot.puzzle_type = my_puzzle->size;
+    snapshot.seed = seed;
+    snapshot.n_nodes = loop_n;
+    snapshot.depth = path_depth;
+    snapshot.deepest_depth = deepest_depth;
+    snapshot.n_backtracks = n_backtracks;
+    snapshot.prune_hits = prune_hits;
+    snapshot.prune_rules = prune_rules;
+    snapshot.tree_size = placement_record.tree_size;
+    telem_publish(&telemetry, &snapshot);
+}
+
+// Progress callback of the dfs and dlx engines, ctx is the mode of the run
+void publish_state_telemetry(search_state* state, void* ctx) {
+    if(enumerate_set) {
+        print_enumeration_progress(state, NULL);
+    }
+    if(!telem_is_due(&telemetry)) {
+        return;
+    }
+
+    telem_snapshot snapshot = {0};
+    snapshot.mode = (char const*)ctx;
+    snapshot.puzzle_type = state->puzzle->size;
+    snapshot.seed = seed;
+    snapshot.n_nodes = state->n_nodes;
+    snapshot.depth = state->depth;
+    snapshot.deepest_depth = state->deepest_depth;
+    snapshot.n_backtracks = state->n_backtracks;
+    snapshot.prune_hits = state->n_prunes;
+    snapshot.prune_rules = state->prune_rules;
+    telem_publish(&telemetry, &snapshot);
+}
+
+void print_prune_hits(uint64_t const* hits, FILE* file_ptr) {
+    for(int rule = NO_PRUNE + 1; rule < N_PRUNE_RULES; ++rule) {
+        if(!(prune_rules & PRUNE_MASK(rule))) {
+            continue;
+        }
+        fprintf(file_ptr, "Prune %s: %" PRIu64 "\n", prune_rule_name(rule),
+                hits[rule]);
+    }
+}
+
+void print_tt_stats(uint64_t hits, uint64_t misses, FILE* file_ptr) {
+    if(tt_size_mb == 0) {
+        return;
+    }
+
+    tt_table* table = &transposition_table;
+    fprintf(file_ptr, "TT Slots: %zu - Used: %zu - Policy: %s\n",
+            table->n_slots, tt_n_used(table), tt_policy_name(table->policy));
+    fprintf(file_ptr,
+            "TT Hits: %" PRIu64 " - Misses: %" PRIu64 " - Stores: %" PRIu64
+            " - Replaced: %" PRIu64 " - Rejected: %" PRIu64 "\n",
+            hits, misses, (uint64_t)atomic_load(&table->n_stores),
+            (uint64_t)atomic_load(&table->n_replaced),
+            (uint64_t)atomic_load(&table->n_rejected));
+}
+
+// Luby et al.: 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+static uint64_t luby(int i) {
+    int k = 1;
+    while((1 << k) - 1 < i) {
+        ++k;
+    }
+    while((1 << k) - 1 != i) {
+        i -= (1 << (k - 1)) - 1;
+        k = 1;
+        while((1 << k) - 1 < i) {
+            ++k;
+        }
+    }
+    return (uint64_t)1 << (k - 1);
+}
+
+uint64_t restart_budget(RESTART_STRATEGY strategy,
+                        uint64_t base,
+                        int restart) {
+    switch(strategy) {
+        case RESTART_LUBY:
+            return base * luby(restart);
+        case RESTART_GEOMETRIC: {
+            double budget = (double)base;
+            for(int i = 1; i < restart && budget < 1e18; ++i) {
+                budget *= RESTART_GEOMETRIC_FACTOR;
             }
+            return (uint64_t)budget;
         }
+        default:
+            return 0;
+    }
+}
+
+char const* restart_strategy_name(RESTART_STRATEGY strategy) {
+    switch(strategy) {
+        case RESTART_LUBY:
+            return "luby";
+        case RESTART_GEOMETRIC:
+            return "geometric";
+        default:
+            return "none";
     }
+}
 
-    return false;
+double wall_time_seconds() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
 }
 
-// - Find smallest, bounded gap in all line scans
-//     * Horizontally + Vertically
+// The first empty cell in row-major order is the cursor kept by
+// place_block/remove_block
+bool line_scan_hor(puzzle_def* puzzle, point* result) {
+    return get_first_empty_cell(puzzle, &result->x_index, &result->y_index);
+}
+
+// Empty cells from the top of the column down to the next block or the
+// bottom of the grid. The dlx engine places blocks below the skyline, on
+// all other boards this is the rest of the column.
+static int get_column_gap(puzzle_def* puzzle, int x_pos, int height) {
+    int grid_size = puzzle->grid_dimension;
+    if(puzzle->n_skyline_cells == puzzle->n_filled_cells) {
+        return grid_size - height;
+    }
+
+    int y_pos = height;
+    while(y_pos < grid_size && !is_cell_occupied(puzzle, x_pos, y_pos)) {
+        ++y_pos;
+    }
+    return y_pos - height;
+}
+
+// Columns of the segment whose gaps have to be checked, the columns of a
+// segment only differ below the skyline
+static int get_n_gap_columns(puzzle_def* puzzle,
+                             skyline_segment const* segment) {
+    return puzzle->n_skyline_cells == puzzle->n_filled_cells ? 1
+                                                             : segment->width;
+}
+
+// - Find smallest, bounded gap on the skyline
+//     * Horizontally: a segment with higher neighbours (or the grid edge)
+//       on both sides, its width is the narrowest line of the valley
+//     * Vertically: the unfilled rest of a column
 bool find_smallest_gap(puzzle_def* puzzle, gap_search_result* res_struct) {
     res_struct->x_index = 0;
     res_struct->y_index = 0;
@@ -419,88 +1454,38 @@ bool find_smallest_gap(puzzle_def* puzzle, gap_search_result* res_struct) {
         return false;
     }
 
-    int** grid = puzzle->puzzle_grid;
-
-    // Horizontal Scan
-    int x_index_hor_scan = 0;
-    int y_index_hor_scan = 0;
-    int size_hor_scan = puzzle->grid_dimension + 1;
-    for(int i = 0; i < puzzle->grid_dimension; ++i) {
-        int line_gap_count = 0;
-        int index_buffer = 0;
-        bool am_counting = false;
-        for(int j = 0; j < puzzle->grid_dimension; ++j) {
-            if(grid[i][j] == 0 && am_counting) {
-                ++line_gap_count;
-            } else if(grid[i][j] == 0 && !am_counting) {
-                ++line_gap_count;
-                index_buffer = j;
-                am_counting = true;
-            } else if((grid[i][j] != 0 ||
-                       // Handle grid edge
-                       j == puzzle->grid_dimension - 1) &&
-                      am_counting) {
-                if(size_hor_scan > line_gap_count) {
-                    size_hor_scan = line_gap_count;
-                    x_index_hor_scan = i;
-                    y_index_hor_scan = index_buffer;
-                }
-                index_buffer = 0;
-                am_counting = false;
-            }
-        }
-        if(size_hor_scan > line_gap_count && am_counting) {
-            size_hor_scan = line_gap_count;
-            x_index_hor_scan = i;
-            y_index_hor_scan = index_buffer;
-        }
-    }
-
-    // Vertical Scan
-    int x_index_ver_scan = 0;
-    int y_index_ver_scan = 0;
-    int size_ver_scan = puzzle->grid_dimension + 1;
-    for(int j = 0; j < puzzle->grid_dimension; ++j) {
-        int column_gap_count = 0;
-        int index_buffer = 0;
-        bool am_counting = false;
-        for(int i = 0; i < puzzle->grid_dimension; ++i) {
-            if(grid[i][j] == 0 && am_counting) {
-                ++column_gap_count;
-            } else if(grid[i][j] == 0 && !am_counting) {
-                ++column_gap_count;
-                index_buffer = i;
-                am_counting = true;
-            } else if((grid[i][j] != 0 ||
-                       // Handle grid edge
-                       j == puzzle->grid_dimension - 1) &&
-                      am_counting) {
-                if(size_ver_scan > column_gap_count) {
-                    size_ver_scan = column_gap_count;
-                    x_index_ver_scan = index_buffer;
-                    y_index_ver_scan = j;
-                }
-                index_buffer = 0;
-                am_counting = false;
-            }
+    int grid_size = puzzle->grid_dimension;
+    skyline_segment* skyline = puzzle->skyline;
+    int n_segments = puzzle->n_segments;
+
+    res_struct->gap = grid_size + 1;
+    for(int i = 0; i < n_segments; ++i) {
+        skyline_segment* segment = &skyline[i];
+        if(segment->height >= grid_size) {
+            continue;
         }
-        if(size_ver_scan > column_gap_count && am_counting) {
-            size_ver_scan = column_gap_count;
-            x_index_ver_scan = index_buffer;
-            y_index_ver_scan = j;
+
+        bool left_bounded = i == 0 || skyline[i - 1].height > segment->height;
+        bool right_bounded =
+            i == n_segments - 1 || skyline[i + 1].height > segment->height;
+        if(left_bounded && right_bounded && segment->width < res_struct->gap) {
+            res_struct->x_index = segment->x_pos;
+            res_struct->y_index = segment->height;
+            res_struct->gap = segment->width;
+            res_struct->type = HORIZONTAL;
         }
-    }
 
-    if(size_hor_scan <= size_ver_scan) {
-        res_struct->x_index = x_index_hor_scan;
-        res_struct->y_index = y_index_hor_scan;
-        res_struct->gap = size_hor_scan;
-        res_struct->type = HORIZONTAL;
-    } else {
-        res_struct->x_index = x_index_ver_scan;
-        res_struct->y_index = y_index_ver_scan;
-        res_struct->gap = size_ver_scan;
-        res_struct->type = VERTICAL;
+        // a column gap never gets narrower than its segment
+        int x_end = segment->x_pos + get_n_gap_columns(puzzle, segment);
+        for(int x = segment->x_pos; x < x_end; ++x) {
+            int column_gap = get_column_gap(puzzle, x, segment->height);
+            if(column_gap < res_struct->gap) {
+                res_struct->x_index = x;
+                res_struct->y_index = segment->height;
+                res_struct->gap = column_gap;
+                res_struct->type = VERTICAL;
+            }
+        }
     }
 
     return true;
@@ -530,50 +1515,144 @@ bool is_solvable_gap_cond(puzzle_def* puzzle) {
     return is_solvable;
 }
 
-int random_tile_select(uint16_t filter, int max_tile_size) {
-    int* candidate_tiles = calloc((size_t)max_tile_size, sizeof(int));
-    int j = 0;
-    for(int i = 1; i <= max_tile_size; ++i) {
-        if((filter >> (i - 1)) & 1) {
-            candidate_tiles[j++] = i;
-        }
+// Checks if the remaining pieces can still fill the skyline:
+// - The columns of every bounded valley have to be covered by pieces
+//   lying side by side on the valley floor -> the width is a sum of sizes
+// - Every column has to be covered by pieces stacked on top of each
+//   other -> the unfilled height is a sum of sizes
+bool is_solvable_subset_sum(puzzle_def* puzzle) {
+    if(is_puzzle_solved(puzzle)) {
+        return true;
     }
 
-    bool tile_not_found = true;
-    int random_tile = 0;
-    do {
-        random_tile = rand() % max_tile_size + 1;
-        for(int i = 0; i < j && tile_not_found; ++i) {
-            if(candidate_tiles[i] == random_tile) {
-                tile_not_found = false;
+    uint64_t sums[SUBSET_SUM_WORDS];
+    get_reachable_sums(puzzle, sums);
+
+    int grid_size = puzzle->grid_dimension;
+    skyline_segment* skyline = puzzle->skyline;
+    int n_segments = puzzle->n_segments;
+    for(int i = 0; i < n_segments; ++i) {
+        skyline_segment* segment = &skyline[i];
+        if(segment->height >= grid_size) {
+            continue;
+        }
+
+        int x_end = segment->x_pos + get_n_gap_columns(puzzle, segment);
+        for(int x = segment->x_pos; x < x_end; ++x) {
+            if(!is_reachable_sum(sums,
+                                 get_column_gap(puzzle, x, segment->height))) {
+                return false;
             }
         }
-    } while(tile_not_found);
-    free(candidate_tiles);
 
-    return random_tile;
+        bool left_bounded = i == 0 || skyline[i - 1].height > segment->height;
+        bool right_bounded =
+            i == n_segments - 1 || skyline[i + 1].height > segment->height;
+        if(left_bounded && right_bounded &&
+           !is_reachable_sum(sums, segment->width)) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
-int largest_tile_select(uint16_t filter, int max_tile_size) {
-    int selected_tile = 0;
-    for(int i = max_tile_size; i > 0; --i) {
-        if((filter >> i) & 1) {
-            selected_tile = i;
-            break;
-        }
+PRUNE_RULE check_prune_rules(puzzle_def* puzzle, int prune_rules) {
+    if((prune_rules & PRUNE_MASK(GAP_PRUNE)) &&
+       !is_solvable_gap_cond(puzzle)) {
+        return GAP_PRUNE;
+    }
+    if((prune_rules & PRUNE_MASK(SUBSET_SUM_PRUNE)) &&
+       !is_solvable_subset_sum(puzzle)) {
+        return SUBSET_SUM_PRUNE;
     }
 
-    return selected_tile;
+    return NO_PRUNE;
 }
 
-uint16_t set_exhausted_tiles(uint16_t valid_tiles) {
-    for(int i = 1; i <= my_puzzle->size; ++i) {
-        int n_tile_pcs = get_n_available_pieces(my_puzzle, i);
-        if(n_tile_pcs == 0) {
-            valid_tiles &= ~(1 << (i - 1));
+char const* prune_rule_name(PRUNE_RULE rule) {
+    switch(rule) {
+        case GAP_PRUNE:
+            return "Gap";
+        case SUBSET_SUM_PRUNE:
+            return "Subset Sum";
+        default:
+            return "None";
+    }
+}
+
+// The corners are filled in the order top left, top right, bottom left
+// and bottom right, so every corner tile only has to be compared with the
+// corners placed before it
+bool is_symmetry_allowed(puzzle_def* puzzle,
+                         int block_id,
+                         int x_pos,
+                         int y_pos) {
+    int grid_size = puzzle->grid_dimension;
+    bool is_top = y_pos == 0;
+    bool is_left = x_pos == 0;
+    bool is_right = x_pos + block_id == grid_size;
+    bool is_bottom = y_pos + block_id == grid_size;
+
+    if((is_top && is_left) || block_id == grid_size) {
+        return true;
+    }
+
+    int const* corners = puzzle->corner_tiles;
+    if(is_top && is_right) {
+        return block_id >= corners[0];
+    }
+    if(is_left && is_bottom) {
+        return block_id >= corners[0] && block_id >= corners[1];
+    }
+    if(is_right && is_bottom) {
+        return block_id >= corners[0];
+    }
+
+    return true;
+}
+
+bool has_ordered_corners(puzzle_def* puzzle, int transform) {
+    int last = puzzle->grid_dimension - 1;
+    int top_left = get_transformed_tile(puzzle, transform, 0, 0);
+    int top_right = get_transformed_tile(puzzle, transform, last, 0);
+    int bottom_left = get_transformed_tile(puzzle, transform, 0, last);
+    int bottom_right = get_transformed_tile(puzzle, transform, last, last);
+
+    return top_left <= top_right && top_left <= bottom_left &&
+           top_left <= bottom_right && top_right <= bottom_left;
+}
+
+void classify_solution(puzzle_def* puzzle,
+                       bool break_symmetry,
+                       bool* is_unique,
+                       int* n_copies) {
+    *is_unique = true;
+    *n_copies = 0;
+    for(int transform = 0; transform < N_SYMMETRIES; ++transform) {
+        bool is_duplicate = false;
+        for(int prev = 0; prev < transform && !is_duplicate; ++prev) {
+            is_duplicate = compare_transforms(puzzle, transform, prev) == 0;
+        }
+        if(is_duplicate) {
+            continue;
+        }
+        ++*n_copies;
+
+        if(transform == 0 ||
+           (break_symmetry && !has_ordered_corners(puzzle, transform))) {
+            continue;
+        }
+        if(compare_transforms(puzzle, transform, 0) < 0) {
+            *is_unique = false;
         }
     }
-    return valid_tiles;
+}
+
+// Also clears the bits above the puzzle size, so the selectors only see
+// tiles of the puzzle
+uint16_t set_exhausted_tiles(uint16_t valid_tiles) {
+    return valid_tiles & dfs_available_tiles(my_puzzle);
 }
 
 int n_ok_tile_types(uint16_t valid_tiles) {
@@ -591,17 +1670,190 @@ void handle_input(int argc, char** argv, int* puzzle_type) {
             visualizer_set = true;
         } else if(strcmp(argv[i], "fulllog") == 0) {
             print_full_log = true;
-        } else if(strcmp(argv[i], "vis") == 0 ||
-                  strcmp(argv[i], "nofulllog") == 0) {
+        } else if(strcmp(argv[i], "enumerate") == 0) {
+            enumerate_set = true;
+        } else if(strcmp(argv[i], "symmetry") == 0) {
+            symmetry_set = true;
+        } else if(strcmp(argv[i], "dlx") == 0) {
+            dlx_set = true;
+        } else if(strcmp(argv[i], "stack") == 0) {
+            stack_set = true;
+        } else if(strcmp(argv[i], "fulltree") == 0) {
+            fulltree_set = true;
+        } else if(strcmp(argv[i], "nosubsetsum") == 0) {
+            prune_rules &= ~PRUNE_MASK(SUBSET_SUM_PRUNE);
+        } else if(strcmp(argv[i], "--threads") == 0) {
+            if(i + 1 >= argc || is_integer(argv[i + 1]) == 0 ||
+               (n_threads = (int)strtol(argv[i + 1], NULL, 10)) < 1) {
+                printf("--threads expects a positive integer.\n");
+                return exit(EXIT_FAILURE);
+            }
+            ++i;
+        } else if(strcmp(argv[i], "--tt") == 0) {
+            long size_mb = 0;
+            if(i + 1 >= argc || is_integer(argv[i + 1]) == 0 ||
+               (size_mb = strtol(argv[i + 1], NULL, 10)) < 1) {
+                printf("--tt expects a positive size in MiB.\n");
+                return exit(EXIT_FAILURE);
+            }
+            tt_size_mb = (size_t)size_mb;
+            ++i;
+        } else if(strcmp(argv[i], "--tree-cap") == 0) {
+            long cap = -1;
+            if(i + 1 >= argc || is_integer(argv[i + 1]) == 0 ||
+               (cap = strtol(argv[i + 1], NULL, 10)) < 0) {
+                printf("--tree-cap expects a non-negative node count.\n");
+                return exit(EXIT_FAILURE);
+            }
+            tree_cap = (size_t)cap;
+            tree_cap_set = true;
+            ++i;
+        } else if(strcmp(argv[i], "--stats") == 0) {
+            if(i + 1 >= argc) {
+                printf("--stats expects a file path.\n");
+                return exit(EXIT_FAILURE);
+            }
+            stats_path = argv[++i];
+        } else if(strcmp(argv[i], "--solutions") == 0) {
+            if(i + 1 >= argc) {
+                printf("--solutions expects a file path.\n");
+                return exit(EXIT_FAILURE);
+            }
+            solutions_path = argv[++i];
+        } else if(strcmp(argv[i], "--checkpoint") == 0) {
+            if(i + 1 >= argc) {
+                printf("--checkpoint expects a file path.\n");
+                return exit(EXIT_FAILURE);
+            }
+            checkpoint_path = argv[++i];
+        } else if(strcmp(argv[i], "--checkpoint-interval") == 0) {
+            long interval = 0;
+            if(i + 1 >= argc || is_integer(argv[i + 1]) == 0 ||
+               (interval = strtol(argv[i + 1], NULL, 10)) < 1) {
+                printf("--checkpoint-interval expects a positive number of "
+                       "seconds.\n");
+                return exit(EXIT_FAILURE);
+            }
+            checkpoint_interval = (double)interval;
+            ++i;
+        } else if(strcmp(argv[i], "--resume") == 0) {
+            if(i + 1 >= argc) {
+                printf("--resume expects a file path.\n");
+                return exit(EXIT_FAILURE);
+            }
+            resume_path = argv[++i];
+        } else if(strcmp(argv[i], "--seed") == 0) {
+            char* end_ptr = NULL;
+            if(i + 1 >= argc) {
+                printf("--seed expects a non-negative integer.\n");
+                return exit(EXIT_FAILURE);
+            }
+            errno = 0;
+            seed = strtoull(argv[i + 1], &end_ptr, 10);
+            if(errno != 0 || end_ptr == argv[i + 1] || *end_ptr != '\0' ||
+               argv[i + 1][0] == '-') {
+                printf("--seed expects a non-negative integer.\n");
+                return exit(EXIT_FAILURE);
+            }
+            seed_set = true;
+            ++i;
+        } else if(strcmp(argv[i], "--restart") == 0) {
+            if(i + 1 < argc && strcmp(argv[i + 1], "luby") == 0) {
+                restart_strategy = RESTART_LUBY;
+            } else if(i + 1 < argc && strcmp(argv[i + 1], "geometric") == 0) {
+                restart_strategy = RESTART_GEOMETRIC;
+            } else {
+                printf("--restart expects luby or geometric.\n");
+                return exit(EXIT_FAILURE);
+            }
+            ++i;
+        } else if(strcmp(argv[i], "--restart-base") == 0) {
+            long base = 0;
+            if(i + 1 >= argc || is_integer(argv[i + 1]) == 0 ||
+               (base = strtol(argv[i + 1], NULL, 10)) < 1) {
+                printf("--restart-base expects a positive node count.\n");
+                return exit(EXIT_FAILURE);
+            }
+            restart_base = (uint64_t)base;
+            ++i;
+        } else if(strcmp(argv[i], "--telemetry") == 0) {
+            if(i + 1 >= argc) {
+                printf("--telemetry expects a file path.\n");
+                return exit(EXIT_FAILURE);
+            }
+            telemetry_path = argv[++i];
+        } else if(strcmp(argv[i], "--telemetry-socket") == 0) {
+            if(i + 1 >= argc) {
+                printf("--telemetry-socket expects a socket path.\n");
+                return exit(EXIT_FAILURE);
+            }
+            telemetry_socket = argv[++i];
+        } else if(strcmp(argv[i], "--telemetry-interval") == 0) {
+            long interval = 0;
+            if(i + 1 >= argc || is_integer(argv[i + 1]) == 0 ||
+               (interval = strtol(argv[i + 1], NULL, 10)) < 1) {
+                printf("--telemetry-interval expects a positive number of "
+                       "seconds.\n");
+                return exit(EXIT_FAILURE);
+            }
+            telemetry_interval = (double)interval;
+            ++i;
+        } else if(strcmp(argv[i], "--fps") == 0) {
+            long fps = 0;
+            if(i + 1 >= argc || is_integer(argv[i + 1]) == 0 ||
+               (fps = strtol(argv[i + 1], NULL, 10)) < 1 || fps > 1000) {
+                printf("--fps expects a frame rate between 1 and 1000.\n");
+                return exit(EXIT_FAILURE);
+            }
+            vis_fps = (int)fps;
+            ++i;
+        } else if(strcmp(argv[i], "--select") == 0) {
+            if(i + 1 >= argc || !sel_parse(argv[i + 1], &select_strategy)) {
+                printf("--select expects random, largest, smallest or "
+                       "pieces.\n");
+                return exit(EXIT_FAILURE);
+            }
+            select_set = true;
+            ++i;
+        } else if(strcmp(argv[i], "--tt-policy") == 0) {
+            if(i + 1 < argc && strcmp(argv[i + 1], "always") == 0) {
+                tt_policy = TT_REPLACE_ALWAYS;
+            } else if(i + 1 < argc && strcmp(argv[i + 1], "larger") == 0) {
+                tt_policy = TT_REPLACE_LARGER;
+            } else {
+                printf("--tt-policy expects always or larger.\n");
+                return exit(EXIT_FAILURE);
+            }
+            ++i;
+        } else if(strcmp(argv[i], "novis") == 0 ||
+                  strcmp(argv[i], "nofulllog") == 0 ||
+                  strcmp(argv[i], "noenumerate") == 0 ||
+                  strcmp(argv[i], "subsetsum") == 0 ||
+                  strcmp(argv[i], "nosymmetry") == 0 ||
+                  strcmp(argv[i], "nodlx") == 0 ||
+                  strcmp(argv[i], "nostack") == 0 ||
+                  strcmp(argv[i], "nofulltree") == 0) {
             continue;
         } else if(strcmp(argv[i], "-h") == 0) {
             printf(
-                "Usage: ./sol.out {number} {vis/novis} {fulllog/nofulllog}\n"
+                "Usage: ./sol.out {number} {vis/novis} {fulllog/nofulllog} "
+                "{enumerate/noenumerate} {subsetsum/nosubsetsum} "
+                "{symmetry/nosymmetry} {dlx/nodlx} {stack/nostack} "
+                "{fulltree/nofulltree} {--threads N} {--tt MiB} "
+                "{--tt-policy always/larger} "
+                "{--select random/largest/smallest/pieces} "
+                "{--seed N} {--restart luby/geometric} {--restart-base N} "
+                "{--tree-cap N} {--stats FILE} {--solutions FILE} "
+                "{--checkpoint FILE} "
+                "{--checkpoint-interval SEC} {--resume FILE} {--fps N} "
+                "{--telemetry FILE} {--telemetry-socket PATH} "
+                "{--telemetry-interval SEC}\n"
                 "Command Line arguments are optional\n"
-                "Defaults: 8 novis nofulllog.\n");
+                "Defaults: 8 novis nofulllog noenumerate subsetsum "
+                "nosymmetry nodlx nostack nofulltree.\n");
             return exit(EXIT_SUCCESS);
         } else if(is_integer(argv[i]) != 0 && !integer_inputted) {
-            int num = (int)strtol(argv[1], NULL, 10);
+            int num = (int)strtol(argv[i], NULL, 10);
             if(num < 0) {
                 printf("A puzzle cannot be defined with a negative number.\n");
                 return exit(EXIT_FAILURE);
@@ -628,7 +1880,16 @@ void handle_input(int argc, char** argv, int* puzzle_type) {
         } else {
             printf(
                 "Command Line argument not recognized: only $number, "
-                "vis/novis, fulllog/nofulllog are accepted.\n"
+                "vis/novis, fulllog/nofulllog, enumerate/noenumerate, "
+                "subsetsum/nosubsetsum, symmetry/nosymmetry, dlx/nodlx, "
+                "stack/nostack, fulltree/nofulltree, --threads N, --tt MiB, "
+                "--tt-policy always/larger, "
+                "--select random/largest/smallest/pieces, --seed N, "
+                "--restart luby/geometric, --restart-base N, --tree-cap N, "
+                "--stats FILE, --solutions FILE, --checkpoint FILE, "
+                "--checkpoint-interval SEC, --resume FILE, --fps N, "
+                "--telemetry FILE, --telemetry-socket PATH, "
+                "--telemetry-interval SEC are accepted.\n"
                 "Usage example: ./sol.out 8 vis nofulllog\n");
             return exit(EXIT_FAILURE);
         }
@@ -663,12 +1924,10 @@ void printWinningBranch(FILE* file_ptr) {
     int extra_spaces_l = extra_spaces / 2 + extra_spaces % 2;
     int extra_spaces_r = extra_spaces / 2;
 
-    tree_node* current_node = last_placement;
     node_placement placement_data = {0};
     uint16_t tiles_mask;
-    bool ascending = true;
-    while(ascending) {
-        placement_data = *(node_placement*)current_node->data;
+    for(int depth = path_depth; depth >= 0; --depth) {
+        placement_data = search_path[depth];
 
         tiles_mask = placement_data.valid_tiles;
 
@@ -689,16 +1948,12 @@ void printWinningBranch(FILE* file_ptr) {
             fprintf(file_ptr, "─");
         fprintf(file_ptr, "┘\n");
 
-        if(current_node->parent != NULL) {
+        if(depth > 0) {
             fprintf(file_ptr, "             %*s∧\n", extra_spaces_l, "");
             fprintf(file_ptr, "            %*s/ \\\n", extra_spaces_l, "");
             fprintf(file_ptr, "             %*s│\n", extra_spaces_l, "");
             fprintf(file_ptr, "             %*s│\n", extra_spaces_l, "");
-        } else {
-            ascending = false;
         }
-
-        current_node = current_node->parent;
     }
 }
 
@@ -759,17 +2014,14 @@ void printTree(tree_node* ptr_node,
         printNode(ptr_node, file_ptr);
     }
 
-    tree_node** pointer_to_children_pointers =
-        (tree_node**)ptr_node->children.ptr_first_elem;
-    tree_node* child_node_ptr = *pointer_to_children_pointers;
-
-    for(size_t i = 0; i != ptr_node->children.dynarr_size; ++i) {
+    tree_node* child_node_ptr = ptr_node->first_child;
+    while(child_node_ptr) {
         // Recursive call for the
         // children nodes
-        bool isLastChild = i == ptr_node->children.dynarr_size - 1;
+        bool isLastChild = child_node_ptr->next_sibling == NULL;
         printTree(child_node_ptr, depth + 1, isLastChild, flag, file_ptr);
 
-        child_node_ptr = *(++pointer_to_children_pointers);
+        child_node_ptr = child_node_ptr->next_sibling;
     }
     flag[depth] = true;
 }
@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <dedup.h>
+#include <puz.h>
+#include <stream.h>
+
+// Reader for the binary solution streams of ./sol.out enumerate --solutions
+// Without options every record is decoded once and the size of the stream
+// is reported. --show N places solution N (counted from 1 like in
+// logs/log.txt) on a board and prints it, --list prints every solution as
+// the placement list of logs/log.txt.
+// --dedup merges all given streams into their unique solutions, rotated
+// and mirrored copies count as one. --set FILE keeps the fingerprints on
+// disk for later merges and bounds the memory use by --set-mb, --out FILE
+// writes the canonical form of every unique solution to a new stream.
+
+static double now_seconds() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void print_placements(stream_cursor* cursor, uint64_t number) {
+    printf("Solution %" PRIu64 ":", number);
+    for(int i = 0; i < cursor->reader->n_placements; ++i) {
+        node_placement* placement = &cursor->placements[i];
+        printf(" %d@(%d,%d)", placement->tile_type, placement->x_pos,
+               placement->y_pos);
+    }
+    printf("\n");
+}
+
+static bool show_solution(stream_reader* reader, uint64_t number) {
+    stream_cursor cursor;
+    stream_cursor_init(&cursor, reader);
+    bool is_found = number > 0 && stream_seek(&cursor, number - 1) &&
+                    stream_next(&cursor);
+    if(!is_found) {
+        printf("The stream has no solution %" PRIu64 ".\n", number);
+        stream_cursor_free(&cursor);
+        return false;
+    }
+    print_placements(&cursor, number);
+
+    puzzle_def puzzle = {0};
+    puzzle.size = reader->puzzle_type;
+    init_puzzle(&puzzle);
+    for(int i = 0; i < reader->n_placements && is_found; ++i) {
+        node_placement* placement = &cursor.placements[i];
+        is_found = place_block(&puzzle, placement->tile_type,
+                               placement->x_pos, placement->y_pos) == SUCCESS;
+    }
+    if(is_found) {
+        print_grid(&puzzle, NULL);
+    } else {
+        printf("The placements of solution %" PRIu64 " overlap.\n", number);
+    }
+
+    free_puzzle(&puzzle);
+    stream_cursor_free(&cursor);
+    return is_found;
+}
+
+static void scan_stream(stream_reader* reader, bool is_listed) {
+    stream_cursor cursor;
+    stream_cursor_init(&cursor, reader);
+
+    double begin = now_seconds();
+    while(stream_next(&cursor)) {
+        if(is_listed) {
+            print_placements(&cursor, cursor.n_read);
+        }
+    }
+    double seconds = now_seconds() - begin;
+
+    if(!is_listed) {
+        size_t n_bytes = (size_t)(reader->records_end - reader->records);
+        printf("Puzzle type: %d - Placements: %d\n", reader->puzzle_type,
+               reader->n_placements);
+        printf("Solutions: %" PRIu64 "%s\n", cursor.n_read,
+               reader->keyframes ? "" : " (stream was not closed)");
+        printf("Record bytes: %zu - Bytes/solution: %.1f\n", n_bytes,
+               cursor.n_read > 0 ? (double)n_bytes / cursor.n_read : 0.0);
+        printf("Decoded in %f seconds - Solutions/sec: %.0f\n", seconds,
+               seconds > 0 ? cursor.n_read / seconds : 0.0);
+    }
+    stream_cursor_free(&cursor);
+}
+
+// Places the solution on the empty board, false if the placements overlap
+static bool place_solution(puzzle_def* puzzle, stream_cursor* cursor) {
+    int n_placed = 0;
+    while(n_placed < cursor->reader->n_placements) {
+        node_placement* placement = &cursor->placements[n_placed];
+        if(place_block(puzzle, placement->tile_type, placement->x_pos,
+                       placement->y_pos) != SUCCESS) {
+            break;
+        }
+        ++n_placed;
+    }
+    if(n_placed == cursor->reader->n_placements) {
+        return true;
+    }
+
+    while(n_placed-- > 0) {
+        node_placement* placement = &cursor->placements[n_placed];
+        remove_block(puzzle, placement->tile_type, placement->x_pos,
+                     placement->y_pos);
+    }
+    return false;
+}
+
+static void remove_solution(puzzle_def* puzzle, stream_cursor* cursor) {
+    for(int i = cursor->reader->n_placements - 1; i >= 0; --i) {
+        node_placement* placement = &cursor->placements[i];
+        remove_block(puzzle, placement->tile_type, placement->x_pos,
+                     placement->y_pos);
+    }
+}
+
+// One pass over all streams, only the fingerprint set is held in memory
+static bool dedup_streams(char** paths,
+                          int n_paths,
+                          char const* set_path,
+                          size_t set_mb,
+                          char const* out_path) {
+    dedup_set set;
+    if(!dedup_open(&set, set_path, set_mb)) {
+        return false;
+    }
+
+    puzzle_def puzzle = {0};
+    node_placement* canonical = NULL;
+    stream_writer writer;
+    bool has_writer = false;
+    uint64_t n_read = 0;
+    uint64_t n_invalid = 0;
+    bool is_ok = true;
+
+    double begin = now_seconds();
+    for(int i = 0; i < n_paths && is_ok; ++i) {
+        stream_reader reader;
+        if(!stream_map(&reader, paths[i])) {
+            is_ok = false;
+            break;
+        }
+
+        if(puzzle.size == 0) {
+            puzzle.size = reader.puzzle_type;
+            init_puzzle(&puzzle);
+            canonical = calloc(reader.n_placements, sizeof(node_placement));
+            if(!canonical) {
+                perror("calloc failed");
+                exit(EXIT_FAILURE);
+            }
+            if(out_path) {
+                is_ok = has_writer =
+                    stream_open(&writer, out_path, reader.puzzle_type);
+            }
+        } else if(reader.puzzle_type != puzzle.size) {
+            printf("%s holds solutions of puzzle type %d instead of %d.\n",
+                   paths[i], reader.puzzle_type, puzzle.size);
+            is_ok = false;
+        }
+
+        stream_cursor cursor;
+        stream_cursor_init(&cursor, &reader);
+        while(is_ok && stream_next(&cursor)) {
+            ++n_read;
+            if(!place_solution(&puzzle, &cursor)) {
+                ++n_invalid;
+                continue;
+            }
+            if(dedup_insert(&set, get_canonical_fingerprint(&puzzle)) &&
+               has_writer) {
+                dedup_canonical_placements(
+                    &puzzle, get_canonical_transform(&puzzle), canonical);
+                stream_write(&writer, canonical);
+            }
+            remove_solution(&puzzle, &cursor);
+        }
+        stream_cursor_free(&cursor);
+        stream_unmap(&reader);
+    }
+    double seconds = now_seconds() - begin;
+
+    size_t set_size = dedup_size(&set);
+    if(has_writer) {
+        is_ok = stream_close(&writer) && is_ok;
+    }
+    is_ok = dedup_close(&set) && is_ok;
+    if(puzzle.size > 0) {
+        free_puzzle(&puzzle);
+    }
+    free(canonical);
+
+    printf("Streams: %d - Solutions read: %" PRIu64 "\n", n_paths, n_read);
+    printf("Unique: %" PRIu64 " - Duplicates: %" PRIu64 "\n",
+           set.n_inserted, set.n_duplicates);
+    if(n_invalid > 0) {
+        printf("Overlapping solutions skipped: %" PRIu64 "\n", n_invalid);
+    }
+    printf("Set size: %zu - Flushes to disk: %zu\n", set_size,
+           set.n_flushes);
+    printf("Merged in %f seconds - Solutions/sec: %.0f\n", seconds,
+           seconds > 0 ? n_read / seconds : 0.0);
+    return is_ok;
+}
+
+static void print_usage() {
+    printf(
+        "Usage: ./solread.out FILE... {--show N} {--list} {--dedup} "
+        "{--set FILE} {--set-mb MiB} {--out FILE}\n"
+        "Defaults: --set-mb %d\n",
+        DEDUP_DEFAULT_SIZE_MB);
+}
+
+int main(int argc, char* argv[]) {
+    char** paths = calloc(argc, sizeof(char*));
+    int n_paths = 0;
+    bool is_shown = false;
+    uint64_t show_number = 0;
+    bool is_listed = false;
+    bool is_deduped = false;
+    char const* set_path = NULL;
+    size_t set_mb = DEDUP_DEFAULT_SIZE_MB;
+    char const* out_path = NULL;
+    if(!paths) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    for(int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if(strcmp(argv[i], "--show") == 0 && has_value) {
+            is_shown = true;
+            show_number = strtoull(argv[++i], NULL, 10);
+        } else if(strcmp(argv[i], "--list") == 0) {
+            is_listed = true;
+        } else if(strcmp(argv[i], "--dedup") == 0) {
+            is_deduped = true;
+        } else if(strcmp(argv[i], "--set") == 0 && has_value) {
+            set_path = argv[++i];
+        } else if(strcmp(argv[i], "--set-mb") == 0 && has_value &&
+                  atoi(argv[i + 1]) > 0) {
+            set_mb = (size_t)atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--out") == 0 && has_value) {
+            out_path = argv[++i];
+        } else if(argv[i][0] != '-') {
+            paths[n_paths++] = argv[i];
+        } else {
+            print_usage();
+            return strcmp(argv[i], "-h") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if(n_paths == 0 || ((set_path || out_path) && !is_deduped)) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    bool is_ok = true;
+    if(is_deduped) {
+        is_ok = dedup_streams(paths, n_paths, set_path, set_mb, out_path);
+    }
+    for(int i = 0; i < n_paths && !is_deduped && is_ok; ++i) {
+        stream_reader reader;
+        if(!stream_map(&reader, paths[i])) {
+            is_ok = false;
+            break;
+        }
+        if(is_shown) {
+            is_ok = show_solution(&reader, show_number);
+        } else {
+            scan_stream(&reader, is_listed);
+        }
+        stream_unmap(&reader);
+    }
+
+    free(paths);
+    return is_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,313 @@
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stream.h>
+
+#define STREAM_WRITE(field) fwrite(&(field), sizeof(field), 1, file_ptr)
+
+// header field offsets
+#define STREAM_VERSION_OFFSET 7
+#define STREAM_TYPE_OFFSET 8
+#define STREAM_PLACEMENTS_OFFSET 10
+#define STREAM_PERIOD_OFFSET 12
+#define STREAM_SOLUTIONS_OFFSET 16
+#define STREAM_INDEX_OFFSET 24
+
+static bool write_header(stream_writer* writer, uint64_t index_offset) {
+    FILE* file_ptr = writer->file_ptr;
+    uint8_t version = STREAM_VERSION;
+    uint16_t puzzle_type = (uint16_t)writer->puzzle_type;
+    uint16_t n_placements = (uint16_t)writer->n_placements;
+    uint32_t period = STREAM_KEYFRAME_PERIOD;
+
+    size_t n_written = fwrite(STREAM_MAGIC, sizeof(STREAM_MAGIC), 1, file_ptr);
+    n_written += STREAM_WRITE(version);
+    n_written += STREAM_WRITE(puzzle_type);
+    n_written += STREAM_WRITE(n_placements);
+    n_written += STREAM_WRITE(period);
+    n_written += STREAM_WRITE(writer->n_solutions);
+    n_written += STREAM_WRITE(index_offset);
+    return n_written == 7;
+}
+
+bool stream_open(stream_writer* writer, char const* path, int puzzle_type) {
+    memset(writer, 0, sizeof(stream_writer));
+    writer->puzzle_type = puzzle_type;
+    writer->n_placements = (puzzle_type * (puzzle_type + 1)) / 2;
+
+    writer->file_ptr = fopen(path, "wb");
+    if(!writer->file_ptr) {
+        perror("solution stream open failed");
+        return false;
+    }
+    writer->buffer = malloc(STREAM_BUFFER_SIZE);
+    writer->previous = calloc(writer->n_placements, sizeof(node_placement));
+    if(!writer->buffer || !writer->previous) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    setvbuf(writer->file_ptr, writer->buffer, _IOFBF, STREAM_BUFFER_SIZE);
+
+    writer->keyframes.elem_size = sizeof(uint64_t);
+    writer->keyframes.dynarr_capacity = 64;
+    dynarr_init(&writer->keyframes);
+
+    write_header(writer, 0);
+    writer->offset = STREAM_HEADER_SIZE;
+    return true;
+}
+
+void stream_write(stream_writer* writer, node_placement const* placements) {
+    int n_shared = 0;
+    if(writer->n_solutions % STREAM_KEYFRAME_PERIOD == 0) {
+        dynarr_append(&writer->keyframes, &writer->offset);
+    } else {
+        while(n_shared < writer->n_placements &&
+              placements[n_shared].tile_type ==
+                  writer->previous[n_shared].tile_type &&
+              placements[n_shared].x_pos == writer->previous[n_shared].x_pos &&
+              placements[n_shared].y_pos == writer->previous[n_shared].y_pos) {
+            ++n_shared;
+        }
+    }
+
+    uint8_t record[1 + 3 * STREAM_MAX_PLACEMENTS];
+    size_t record_size = 0;
+    record[record_size++] = (uint8_t)n_shared;
+    for(int i = n_shared; i < writer->n_placements; ++i) {
+        record[record_size++] = placements[i].tile_type;
+        record[record_size++] = placements[i].x_pos;
+        record[record_size++] = placements[i].y_pos;
+        writer->previous[i] = placements[i];
+    }
+    if(fwrite(record, 1, record_size, writer->file_ptr) != record_size) {
+        writer->is_failed = true;
+    }
+
+    writer->offset += record_size;
+    ++writer->n_solutions;
+}
+
+bool stream_close(stream_writer* writer) {
+    FILE* file_ptr = writer->file_ptr;
+
+    // the index is 8 byte aligned, so the reader can use it in place
+    uint8_t padding[8] = {0};
+    size_t n_padding = (8 - writer->offset % 8) % 8;
+    uint64_t index_offset = writer->offset + n_padding;
+    size_t n_keyframes = writer->keyframes.dynarr_size;
+    // the index is only written if every record made it into the file,
+    // its offsets would not match the data otherwise
+    bool is_ok = !writer->is_failed && !ferror(file_ptr);
+    is_ok = is_ok && fwrite(padding, 1, n_padding, file_ptr) == n_padding &&
+            fwrite(writer->keyframes.ptr_first_elem, sizeof(uint64_t),
+                   n_keyframes, file_ptr) == n_keyframes;
+
+    is_ok = is_ok && fseek(file_ptr, 0, SEEK_SET) == 0 &&
+            write_header(writer, index_offset);
+    is_ok = fclose(file_ptr) == 0 && is_ok;
+    if(!is_ok) {
+        perror("solution stream write failed");
+    }
+
+    free(writer->buffer);
+    free(writer->previous);
+    dynarr_free(&writer->keyframes);
+    return is_ok;
+}
+
+static void unmap_data(stream_reader* reader) {
+#ifdef _WIN32
+    free((void*)reader->data);
+#else
+    munmap((void*)reader->data, reader->size);
+#endif
+    reader->data = NULL;
+}
+
+bool stream_map(stream_reader* reader, char const* path) {
+    memset(reader, 0, sizeof(stream_reader));
+
+#ifdef _WIN32
+    // no mmap, the file is read into memory instead
+    FILE* file_ptr = fopen(path, "rb");
+    if(!file_ptr) {
+        perror("solution stream open failed");
+        return false;
+    }
+    fseek(file_ptr, 0, SEEK_END);
+    reader->size = (size_t)ftell(file_ptr);
+    fseek(file_ptr, 0, SEEK_SET);
+    uint8_t* data = malloc(reader->size + 1);
+    if(!data) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    size_t n_read = fread(data, 1, reader->size, file_ptr);
+    fclose(file_ptr);
+    reader->data = data;
+    if(n_read != reader->size) {
+        perror("solution stream read failed");
+        unmap_data(reader);
+        return false;
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if(fd == -1) {
+        perror("solution stream open failed");
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) == -1 || st.st_size < STREAM_HEADER_SIZE) {
+        fprintf(stderr, "%s is not a solution stream.\n", path);
+        close(fd);
+        return false;
+    }
+    reader->size = (size_t)st.st_size;
+    void* data = mmap(NULL, reader->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) {
+        perror("mmap failed");
+        return false;
+    }
+    // records are read front to back
+    madvise(data, reader->size, MADV_SEQUENTIAL);
+    reader->data = data;
+#endif
+
+    uint8_t version = 0;
+    uint16_t puzzle_type = 0;
+    uint16_t n_placements = 0;
+    uint32_t period = 0;
+    uint64_t index_offset = 0;
+    if(reader->size >= STREAM_HEADER_SIZE) {
+        memcpy(&version, reader->data + STREAM_VERSION_OFFSET, 1);
+        memcpy(&puzzle_type, reader->data + STREAM_TYPE_OFFSET, 2);
+        memcpy(&n_placements, reader->data + STREAM_PLACEMENTS_OFFSET, 2);
+        memcpy(&period, reader->data + STREAM_PERIOD_OFFSET, 4);
+        memcpy(&reader->n_solutions, reader->data + STREAM_SOLUTIONS_OFFSET,
+               8);
+        memcpy(&index_offset, reader->data + STREAM_INDEX_OFFSET, 8);
+    }
+    if(reader->size < STREAM_HEADER_SIZE ||
+       memcmp(reader->data, STREAM_MAGIC, sizeof(STREAM_MAGIC)) != 0 ||
+       version != STREAM_VERSION || period != STREAM_KEYFRAME_PERIOD ||
+       n_placements == 0 || n_placements > STREAM_MAX_PLACEMENTS ||
+       n_placements != (puzzle_type * (puzzle_type + 1)) / 2) {
+        fprintf(stderr, "%s is not a solution stream of this version.\n",
+                path);
+        unmap_data(reader);
+        return false;
+    }
+
+    reader->puzzle_type = puzzle_type;
+    reader->n_placements = n_placements;
+    reader->records = reader->data + STREAM_HEADER_SIZE;
+    reader->records_end = reader->data + reader->size;
+
+    if(index_offset != 0) {
+        uint64_t n_keyframes =
+            (reader->n_solutions + STREAM_KEYFRAME_PERIOD - 1) /
+            STREAM_KEYFRAME_PERIOD;
+        if(index_offset < STREAM_HEADER_SIZE || index_offset % 8 != 0 ||
+           index_offset + n_keyframes * sizeof(uint64_t) != reader->size) {
+            fprintf(stderr, "%s is truncated or corrupt.\n", path);
+            unmap_data(reader);
+            return false;
+        }
+        reader->records_end = reader->data + index_offset;
+        reader->keyframes = (uint64_t const*)(reader->data + index_offset);
+        reader->n_keyframes = n_keyframes;
+    }
+
+    return true;
+}
+
+void stream_unmap(stream_reader* reader) {
+    if(reader->data) {
+        unmap_data(reader);
+    }
+}
+
+void stream_cursor_init(stream_cursor* cursor, stream_reader const* reader) {
+    cursor->reader = reader;
+    cursor->next = reader->records;
+    cursor->n_read = 0;
+    cursor->placements = calloc(reader->n_placements, sizeof(node_placement));
+    if(!cursor->placements) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+}
+
+bool stream_next(stream_cursor* cursor) {
+    stream_reader const* reader = cursor->reader;
+    if(reader->keyframes && cursor->n_read >= reader->n_solutions) {
+        return false;
+    }
+    if(cursor->next >= reader->records_end) {
+        return false;
+    }
+
+    int n_shared = cursor->next[0];
+    size_t record_size = 1 + 3 * (size_t)(reader->n_placements - n_shared);
+    // a stream that was not closed may end in a partial record, and the
+    // first record has nothing to share
+    if(n_shared > reader->n_placements ||
+       (size_t)(reader->records_end - cursor->next) < record_size ||
+       (cursor->n_read == 0 && n_shared != 0)) {
+        return false;
+    }
+
+    uint8_t const* fields = cursor->next + 1;
+    for(int i = n_shared; i < reader->n_placements; ++i) {
+        cursor->placements[i].tile_type = *fields++;
+        cursor->placements[i].x_pos = *fields++;
+        cursor->placements[i].y_pos = *fields++;
+    }
+
+    cursor->next += record_size;
+    ++cursor->n_read;
+    return true;
+}
+
+bool stream_seek(stream_cursor* cursor, uint64_t index) {
+    stream_reader const* reader = cursor->reader;
+    if(reader->keyframes) {
+        if(index >= reader->n_solutions) {
+            return false;
+        }
+        uint64_t keyframe = index / STREAM_KEYFRAME_PERIOD;
+        uint64_t offset = reader->keyframes[keyframe];
+        if(offset < STREAM_HEADER_SIZE ||
+           offset >= (uint64_t)(reader->records_end - reader->data)) {
+            return false;
+        }
+        cursor->next = reader->data + offset;
+        cursor->n_read = keyframe * STREAM_KEYFRAME_PERIOD;
+    } else if(index < cursor->n_read) {
+        cursor->next = reader->records;
+        cursor->n_read = 0;
+    }
+
+    // the first record after the jump is a keyframe, stream_next rebuilds
+    // the shared prefix of the records up to index
+    while(cursor->n_read < index) {
+        if(!stream_next(cursor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void stream_cursor_free(stream_cursor* cursor) {
+    free(cursor->placements);
+    cursor->placements = NULL;
+}
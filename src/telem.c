@@ -0,0 +1,248 @@
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <fileio.h>
+#include <telem.h>
+
+static volatile sig_atomic_t snapshot_requested;
+
+#ifdef SIGUSR1
+static void request_snapshot(int signum) {
+    (void)signum;
+    snapshot_requested = 1;
+}
+#endif
+
+static double telem_time() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Current and peak resident set size in KiB, 0 where unknown
+static void read_rss(long* rss_kb, long* peak_rss_kb) {
+    *rss_kb = 0;
+    *peak_rss_kb = 0;
+#ifdef __linux__
+    FILE* file_ptr = fopen("/proc/self/statm", "r");
+    if(file_ptr) {
+        long n_pages = 0;
+        long n_resident = 0;
+        if(fscanf(file_ptr, "%ld %ld", &n_pages, &n_resident) == 2) {
+            *rss_kb = n_resident * (sysconf(_SC_PAGESIZE) / 1024);
+        }
+        fclose(file_ptr);
+    }
+#endif
+#ifndef _WIN32
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0) {
+        *peak_rss_kb = usage.ru_maxrss;
+    }
+#endif
+}
+
+#ifndef _WIN32
+static bool open_socket(telem_state* telem) {
+    struct sockaddr_un address = {0};
+    if(strlen(telem->socket_path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "%s is too long for a socket path.\n",
+                telem->socket_path);
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, telem->socket_path);
+
+    telem->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(telem->listen_fd == -1) {
+        perror("telemetry socket failed");
+        return false;
+    }
+    // a socket left behind by an earlier run is replaced
+    unlink(telem->socket_path);
+    if(bind(telem->listen_fd, (struct sockaddr*)&address, sizeof(address)) ==
+           -1 ||
+       listen(telem->listen_fd, TELEM_MAX_CLIENTS) == -1) {
+        perror("telemetry socket failed");
+        close(telem->listen_fd);
+        telem->listen_fd = -1;
+        return false;
+    }
+    fcntl(telem->listen_fd, F_SETFL,
+          fcntl(telem->listen_fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+static void accept_clients(telem_state* telem) {
+    while(telem->n_clients < TELEM_MAX_CLIENTS) {
+        int client_fd = accept(telem->listen_fd, NULL, NULL);
+        if(client_fd == -1) {
+            return;
+        }
+        telem->clients[telem->n_clients++] = client_fd;
+    }
+}
+
+// The snapshot is small, a client that does not read it is dropped
+static void serve_clients(telem_state* telem, size_t len) {
+    for(int i = 0; i < telem->n_clients; ++i) {
+        int client_fd = telem->clients[i];
+        fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL) | O_NONBLOCK);
+        char const* data = telem->buffer;
+        size_t n_left = len;
+        while(n_left > 0) {
+            ssize_t n_written = send(client_fd, data, n_left, MSG_NOSIGNAL);
+            if(n_written < 0 && errno == EINTR) {
+                continue;
+            }
+            if(n_written <= 0) {
+                break;
+            }
+            data += n_written;
+            n_left -= (size_t)n_written;
+        }
+        close(client_fd);
+    }
+    telem->n_clients = 0;
+}
+#endif
+
+static void write_file(telem_state* telem, size_t len) {
+    file_replace file;
+    if(!file_replace_open(&file, telem->path, "w")) {
+        perror("telemetry file open failed");
+        return;
+    }
+    bool is_ok = fwrite(telem->buffer, 1, len, file.file_ptr) == len;
+    if(!file_replace_commit(&file, is_ok)) {
+        perror("telemetry file write failed");
+    }
+}
+
+bool telem_open(telem_state* telem,
+                char const* path,
+                char const* socket_path,
+                double interval) {
+    memset(telem, 0, sizeof(telem_state));
+    telem->path = path;
+    telem->socket_path = socket_path;
+    telem->interval = interval;
+    telem->listen_fd = -1;
+
+    telem->begin = telem_time();
+    telem->last_time = telem->begin;
+    telem->next_due = telem->begin + interval;
+
+    if(socket_path) {
+#ifdef _WIN32
+        printf("The telemetry socket is not available on Windows.\n");
+        telem->socket_path = NULL;
+#else
+        if(!open_socket(telem)) {
+            return false;
+        }
+#endif
+    }
+#ifdef SIGUSR1
+    signal(SIGUSR1, request_snapshot);
+#endif
+    return true;
+}
+
+bool telem_is_due(telem_state* telem) {
+#ifndef _WIN32
+    if(telem->listen_fd != -1) {
+        accept_clients(telem);
+    }
+#endif
+    return snapshot_requested || telem->n_clients > 0 ||
+           telem_time() >= telem->next_due;
+}
+
+void telem_publish(telem_state* telem, telem_snapshot const* snapshot) {
+    double now = telem_time();
+    double elapsed = now - telem->begin;
+    double since_last = now - telem->last_time;
+    double nodes_per_sec =
+        since_last > 0
+            ? (double)(snapshot->n_nodes - telem->last_nodes) / since_last
+            : 0;
+    long rss_kb = 0;
+    long peak_rss_kb = 0;
+    read_rss(&rss_kb, &peak_rss_kb);
+
+    size_t len = 0;
+    size_t size = sizeof(telem->buffer);
+#define TELEM_PRINT(...)                                                      \
+    if(len < size) {                                                          \
+        len += (size_t)snprintf(telem->buffer + len, size - len, __VA_ARGS__); \
+    }
+    TELEM_PRINT("mode %s\n", snapshot->mode);
+    TELEM_PRINT("size %d\n", snapshot->puzzle_type);
+    TELEM_PRINT("seed %" PRIu64 "\n", snapshot->seed);
+    TELEM_PRINT("snapshot %" PRIu64 "\n", telem->n_published + 1);
+    TELEM_PRINT("elapsed %f\n", elapsed);
+    TELEM_PRINT("nodes %" PRIu64 "\n", snapshot->n_nodes);
+    TELEM_PRINT("nodes_per_sec %.0f\n", nodes_per_sec);
+    TELEM_PRINT("depth %d\n", snapshot->depth);
+    TELEM_PRINT("max_depth %d\n", snapshot->deepest_depth);
+    TELEM_PRINT("backtracks %" PRIu64 "\n", snapshot->n_backtracks);
+    for(int rule = NO_PRUNE + 1; rule < N_PRUNE_RULES; ++rule) {
+        if(!(snapshot->prune_rules & PRUNE_MASK(rule))) {
+            continue;
+        }
+        // "Subset Sum" -> prune_subset_sum
+        char key[64] = "prune_";
+        char const* name = prune_rule_name(rule);
+        size_t key_len = strlen(key);
+        for(; *name && key_len < sizeof(key) - 1; ++name) {
+            key[key_len++] = *name == ' ' ? '_' : (char)tolower(*name);
+        }
+        key[key_len] = '\0';
+        TELEM_PRINT("%s %" PRIu64 "\n", key, snapshot->prune_hits[rule]);
+    }
+    TELEM_PRINT("tree_size %zu\n", snapshot->tree_size);
+    TELEM_PRINT("rss_kb %ld\n", rss_kb);
+    TELEM_PRINT("peak_rss_kb %ld\n", peak_rss_kb);
+#undef TELEM_PRINT
+    len = len < size ? len : size - 1;
+
+    if(telem->path) {
+        write_file(telem, len);
+    }
+#ifndef _WIN32
+    serve_clients(telem, len);
+#endif
+
+    snapshot_requested = 0;
+    telem->last_time = now;
+    telem->last_nodes = snapshot->n_nodes;
+    telem->next_due = now + telem->interval;
+    ++telem->n_published;
+}
+
+void telem_close(telem_state* telem) {
+#ifndef _WIN32
+    if(telem->listen_fd != -1) {
+        close(telem->listen_fd);
+        unlink(telem->socket_path);
+        telem->listen_fd = -1;
+    }
+#endif
+#ifdef SIGUSR1
+    signal(SIGUSR1, SIG_DFL);
+#endif
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <tt.h>
+
+void tt_init(tt_table* table, size_t size_mb, TT_POLICY policy) {
+    size_t max_slots = (size_mb << 20) / sizeof(uint64_t);
+    size_t n_slots = 1;
+    while(n_slots * 2 <= max_slots) {
+        n_slots *= 2;
+    }
+
+    table->slots = calloc(n_slots, sizeof(uint64_t));
+    if(!table->slots) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    table->n_slots = n_slots;
+    table->policy = policy;
+
+    atomic_init(&table->n_stores, 0);
+    atomic_init(&table->n_replaced, 0);
+    atomic_init(&table->n_rejected, 0);
+}
+
+void tt_free(tt_table* table) {
+    free((void*)table->slots);
+    table->slots = NULL;
+    table->n_slots = 0;
+}
+
+uint64_t tt_state_key(puzzle_def* puzzle, bool break_symmetry) {
+    uint64_t key = puzzle->state_hash;
+    if(break_symmetry) {
+        uint64_t corners = (uint64_t)puzzle->corner_tiles[0] << 8 |
+                           (uint64_t)puzzle->corner_tiles[1];
+        key ^= (corners + 1) * 0x9E3779B97F4A7C15ULL;
+    }
+    return key;
+}
+
+static _Atomic uint64_t* tt_slot(tt_table* table, uint64_t key) {
+    return &table->slots[(key >> 8) & (table->n_slots - 1)];
+}
+
+bool tt_probe(tt_table* table, uint64_t key) {
+    uint64_t entry = atomic_load_explicit(tt_slot(table, key),
+                                          memory_order_relaxed);
+    return entry != 0 && (entry & TT_KEY_MASK) == (key & TT_KEY_MASK);
+}
+
+void tt_store(tt_table* table, uint64_t key, int n_remaining) {
+    _Atomic uint64_t* slot = tt_slot(table, key);
+    uint64_t priority = n_remaining < 1 ? 1
+                        : n_remaining > TT_MAX_PRIORITY
+                            ? TT_MAX_PRIORITY
+                            : (uint64_t)n_remaining;
+    uint64_t entry = atomic_load_explicit(slot, memory_order_relaxed);
+    bool is_other = entry != 0 &&
+                    (entry & TT_KEY_MASK) != (key & TT_KEY_MASK);
+
+    if(is_other && table->policy == TT_REPLACE_LARGER &&
+       (entry & ~TT_KEY_MASK) > priority) {
+        atomic_fetch_add_explicit(&table->n_rejected, 1,
+                                  memory_order_relaxed);
+        return;
+    }
+    if(is_other) {
+        atomic_fetch_add_explicit(&table->n_replaced, 1,
+                                  memory_order_relaxed);
+    }
+
+    atomic_store_explicit(slot, (key & TT_KEY_MASK) | priority,
+                          memory_order_relaxed);
+    atomic_fetch_add_explicit(&table->n_stores, 1, memory_order_relaxed);
+}
+
+int tt_remaining_pieces(puzzle_def* puzzle) {
+    int n_remaining = 0;
+    for(int i = 1; i <= puzzle->size; ++i) {
+        n_remaining += get_n_available_pieces(puzzle, i);
+    }
+    return n_remaining;
+}
+
+size_t tt_n_used(tt_table* table) {
+    size_t n_used = 0;
+    for(size_t i = 0; i < table->n_slots; ++i) {
+        n_used += atomic_load_explicit(&table->slots[i],
+                                       memory_order_relaxed) != 0;
+    }
+    return n_used;
+}
+
+char const* tt_policy_name(TT_POLICY policy) {
+    switch(policy) {
+        case TT_REPLACE_ALWAYS:
+            return "always";
+        case TT_REPLACE_LARGER:
+            return "larger";
+        default:
+            return "none";
+    }
+}
@@ -1,3 +1,4 @@
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,9 +9,16 @@
 
 #include <vis.h>
 #define STEP_SIZE 2
+#define FILLED_CELL "▀▀"
+#ifdef TESTING
+#define EMPTY_CELL ".."
+#else
+#define EMPTY_CELL "  "
+#endif
 
 COLOR* set_block_colors;
 int size;
+static vis_frame screen;
 
 void def_block_colors(int* in_block_colors, int size) {
     set_block_colors = malloc(sizeof(int) * size);
@@ -39,7 +47,8 @@ void set_vis_block_color(int block_size, COLOR color, int x_pos, int y_pos) {
 
     for(int i = 0; i < block_size; ++i) {
         for(int j = 0; j < block_size; ++j) {
-            printf("\x1b[38;5;%dm\x1b[48;5;%dm▀▀\x1b[0m", color, color);
+            printf("\x1b[38;5;%dm\x1b[48;5;%dm" FILLED_CELL "\x1b[0m", color,
+                   color);
         }
         printf("\x1b[1B\x1b[%dG", x_shift);
     }
@@ -60,11 +69,7 @@ void remove_vis_block(int block_size, int x_pos, int y_pos) {
 
     for(int i = 0; i < block_size; ++i) {
         for(int j = 0; j < block_size; ++j) {
-#ifdef TESTING
-            printf("..");
-#else
-            printf("  ");
-#endif
+            printf(EMPTY_CELL);
         }
         printf("\x1b[1B\x1b[%dG", x_shift);
     }
@@ -100,6 +105,193 @@ void record_vis_grid(int size) {
     printf("\x1b[%dB\n", size);
 }
 
+// the grid is drawn with the cursor on its top left cell in column 1
+static void frame_reserve(vis_frame* frame, size_t n_bytes) {
+    if(frame->out_len + n_bytes <= frame->out_capacity) {
+        return;
+    }
+    size_t capacity = frame->out_capacity > 0 ? frame->out_capacity : 4096;
+    while(capacity < frame->out_len + n_bytes) {
+        capacity *= 2;
+    }
+    char* out = realloc(frame->out, capacity);
+    if(!out) {
+        perror("realloc failed");
+        exit(EXIT_FAILURE);
+    }
+    frame->out = out;
+    frame->out_capacity = capacity;
+}
+
+static void frame_append(vis_frame* frame, char const* str, size_t len) {
+    frame_reserve(frame, len);
+    memcpy(frame->out + frame->out_len, str, len);
+    frame->out_len += len;
+}
+
+static void frame_append_sequence(vis_frame* frame,
+                                  char const* format,
+                                  int value) {
+    char sequence[32];
+    int len = snprintf(sequence, sizeof(sequence), format, value, value);
+    frame_append(frame, sequence, (size_t)len);
+}
+
+static void frame_write(char const* data, size_t len) {
+    fflush(stdout);
+#ifdef __linux__
+    while(len > 0) {
+        ssize_t n_written = write(STDOUT_FILENO, data, len);
+        if(n_written < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += n_written;
+        len -= (size_t)n_written;
+    }
+#else
+    fwrite(data, 1, len, stdout);
+    fflush(stdout);
+#endif
+}
+
+void vis_frame_init(vis_frame* frame, int size) {
+    memset(frame, 0, sizeof(vis_frame));
+    frame->size = size;
+    frame->front = malloc((size_t)size * size * sizeof(uint16_t) + 1);
+    frame->back = malloc((size_t)size * size * sizeof(uint16_t) + 1);
+    if(!frame->front || !frame->back) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    // the first flush draws every cell
+    for(int i = 0; i < size * size; ++i) {
+        frame->front[i] = VIS_CELL_UNKNOWN;
+    }
+    vis_frame_clear(frame);
+}
+
+void vis_frame_free(vis_frame* frame) {
+    free(frame->front);
+    free(frame->back);
+    free(frame->out);
+    memset(frame, 0, sizeof(vis_frame));
+}
+
+void vis_frame_clear(vis_frame* frame) {
+    for(int i = 0; i < frame->size * frame->size; ++i) {
+        frame->back[i] = VIS_CELL_EMPTY;
+    }
+}
+
+void vis_frame_set_block(vis_frame* frame,
+                         int block_size,
+                         COLOR color,
+                         int x_pos,
+                         int y_pos) {
+    for(int i = 0; i < block_size; ++i) {
+        uint16_t* row = frame->back + (size_t)(y_pos + i) * frame->size;
+        for(int j = 0; j < block_size; ++j) {
+            row[x_pos + j] = (uint16_t)color;
+        }
+    }
+}
+
+size_t vis_frame_flush(vis_frame* frame) {
+    int size = frame->size;
+    frame->out_len = 0;
+
+    // cursor_x is the next cell the cursor would draw on its row
+    int cursor_x = 0;
+    int cursor_y = 0;
+    frame_append(frame, "\x1b[s", 3);
+    for(int y_pos = 0; y_pos < size; ++y_pos) {
+        uint16_t* front_row = frame->front + (size_t)y_pos * size;
+        uint16_t const* back_row = frame->back + (size_t)y_pos * size;
+
+        int x_pos = 0;
+        while(x_pos < size) {
+            if(front_row[x_pos] == back_row[x_pos]) {
+                ++x_pos;
+                continue;
+            }
+            uint16_t color = back_row[x_pos];
+            int x_end = x_pos + 1;
+            while(x_end < size && front_row[x_end] != back_row[x_end] &&
+                  back_row[x_end] == color) {
+                ++x_end;
+            }
+
+            if(y_pos != cursor_y) {
+                frame_append_sequence(frame, "\x1b[%dB", y_pos - cursor_y);
+                cursor_y = y_pos;
+                cursor_x = -1;
+            }
+            if(x_pos != cursor_x) {
+                frame_append_sequence(frame, "\x1b[%dG",
+                                      STEP_SIZE * x_pos + 1);
+            }
+
+            if(color == VIS_CELL_EMPTY) {
+                for(int x = x_pos; x < x_end; ++x) {
+                    frame_append(frame, EMPTY_CELL, sizeof(EMPTY_CELL) - 1);
+                }
+            } else {
+                frame_append_sequence(frame, "\x1b[38;5;%dm\x1b[48;5;%dm",
+                                      color);
+                for(int x = x_pos; x < x_end; ++x) {
+                    frame_append(frame, FILLED_CELL, sizeof(FILLED_CELL) - 1);
+                }
+                frame_append(frame, "\x1b[0m", 4);
+            }
+
+            memcpy(front_row + x_pos, back_row + x_pos,
+                   (size_t)(x_end - x_pos) * sizeof(uint16_t));
+            cursor_x = x_end;
+            x_pos = x_end;
+        }
+    }
+    frame_append(frame, "\x1b[u", 3);
+
+    // nothing changed
+    if(frame->out_len == 6) {
+        return 0;
+    }
+    frame_write(frame->out, frame->out_len);
+    return frame->out_len;
+}
+
+void prep_vis_frame(int size) {
+    if(!screen.front) {
+        vis_frame_init(&screen, size);
+        for(int line = 0; line < size; ++line) {
+            putchar('\n');
+        }
+        printf("\x1b[%dA", size);
+        return;
+    }
+    vis_frame_clear(&screen);
+}
+
+void render_vis_frame(int size) {
+    vis_frame_flush(&screen);
+}
+
+// the cursor is back on the top left cell after every flush
+void reset_vis_frame(int size) {}
+
+void set_vis_frame_block(int block_size, int x_pos, int y_pos) {
+    vis_frame_set_block(&screen, block_size, get_block_color(block_size),
+                        x_pos, y_pos);
+}
+
+void remove_vis_frame_block(int block_size, int x_pos, int y_pos) {
+    vis_frame_set_block(&screen, block_size, (COLOR)VIS_CELL_EMPTY, x_pos,
+                        y_pos);
+}
+
 #ifdef BUILD_VIS
 int main() {
     int grid_size = 45;